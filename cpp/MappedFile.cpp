@@ -0,0 +1,126 @@
+#include "../include/MappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CommonUtilities::MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+bool CommonUtilities::MappedFile::Open(const char* aPath)
+{
+	Close();
+
+	HANDLE file = CreateFileA(aPath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	myFile = file;
+	myMapping = mapping;
+	myData = data;
+	mySize = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+void CommonUtilities::MappedFile::Close()
+{
+	if (myData)
+	{
+		UnmapViewOfFile(myData);
+		CloseHandle(myMapping);
+		CloseHandle(myFile);
+	}
+	myData = nullptr;
+	myMapping = nullptr;
+	myFile = nullptr;
+	mySize = 0;
+}
+#else
+bool CommonUtilities::MappedFile::Open(const char* aPath)
+{
+	Close();
+
+	const int file = open(aPath, O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(file, &status) != 0 || status.st_size == 0)
+	{
+		close(file);
+		return false;
+	}
+
+	// The mapping keeps its own reference to the file, so the descriptor can go right away
+	void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	myData = data;
+	mySize = static_cast<size_t>(status.st_size);
+	return true;
+}
+
+void CommonUtilities::MappedFile::Close()
+{
+	if (myData)
+	{
+		munmap(const_cast<void*>(myData), mySize);
+	}
+	myData = nullptr;
+	mySize = 0;
+}
+#endif
+
+bool CommonUtilities::MappedFile::IsOpen() const
+{
+	return myData != nullptr;
+}
+
+const void* CommonUtilities::MappedFile::GetData() const
+{
+	return myData;
+}
+
+size_t CommonUtilities::MappedFile::GetSize() const
+{
+	return mySize;
+}
@@ -0,0 +1,266 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include "Queue.hpp"
+
+namespace CommonUtilities
+{
+	// Bounded Queue for handing work between threads. Push blocks while the queue is full, so a slow
+	// consumer holds its producers back instead of letting the queue grow, and Pop blocks while it is empty.
+	// Close wakes everyone up: pushes fail from then on and pops drain what is left before failing.
+	// With a spin count, a blocking call first polls that many times before sleeping on the condition
+	// variable, which saves the wake-up latency when the other side is only a moment behind.
+	template <class T>
+	class BlockingQueue
+	{
+	public:
+		BlockingQueue(int aCapacity, int aSpinCount = 0);
+		BlockingQueue(const BlockingQueue&) = delete;
+		BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+		// Wait for room, return false if the queue is closed
+		bool Push(const T& aValue);
+		bool Push(T&& aValue);
+		// Return false right away if the queue is full or closed
+		bool TryPush(const T& aValue);
+		bool TryPush(T&& aValue);
+
+		// Waits for an element, returns false once the queue is closed and empty
+		bool Pop(T& outValue);
+		// Returns false right away if the queue is empty
+		bool TryPop(T& outValue);
+		// Waits at most aTimeout for an element
+		template <class Rep, class Period>
+		bool PopFor(T& outValue, const std::chrono::duration<Rep, Period>& aTimeout);
+		// Waits for at least one element, then moves out as many as fit in outValues under one lock.
+		// Returns how many, 0 once the queue is closed and empty.
+		int PopBatch(std::span<T> outValues);
+		// Like PopBatch but returns 0 right away if the queue is empty
+		int TryPopBatch(std::span<T> outValues);
+
+		void Close();
+		bool IsClosed() const;
+		// Only a snapshot while other threads are running
+		int GetSize() const;
+		int GetCapacity() const;
+
+	private:
+		template <class V>
+		bool PushImpl(V&& aValue, bool aWait);
+		int PopLocked(std::unique_lock<std::mutex>& aLock, std::span<T> outValues);
+		// Polls aCondition up to mySpinCount times, returns true as soon as it holds
+		template <class Condition>
+		bool Spin(Condition&& aCondition) const;
+
+		mutable std::mutex myMutex;
+		std::condition_variable myNotEmpty;
+		std::condition_variable myNotFull;
+		Queue<T> myQueue;
+		std::atomic<int> mySize;		// Mirrors myQueue's size so spinning doesn't need the lock
+		std::atomic<bool> myIsClosed;
+		int myWaitingConsumers;
+		int myWaitingProducers;
+		int myCapacity;
+		int mySpinCount;
+	};
+
+	template <class T>
+	BlockingQueue<T>::BlockingQueue(int aCapacity, int aSpinCount)
+		: mySize(0), myIsClosed(false), myWaitingConsumers(0), myWaitingProducers(0), myCapacity(aCapacity > 1 ? aCapacity : 1), mySpinCount(aSpinCount)
+	{
+		myQueue.Reserve(myCapacity);
+	}
+
+	template <class T>
+	bool BlockingQueue<T>::Push(const T& aValue)
+	{
+		return PushImpl(aValue, true);
+	}
+
+	template <class T>
+	bool BlockingQueue<T>::Push(T&& aValue)
+	{
+		return PushImpl(std::move(aValue), true);
+	}
+
+	template <class T>
+	bool BlockingQueue<T>::TryPush(const T& aValue)
+	{
+		return PushImpl(aValue, false);
+	}
+
+	template <class T>
+	bool BlockingQueue<T>::TryPush(T&& aValue)
+	{
+		return PushImpl(std::move(aValue), false);
+	}
+
+	template <class T>
+	template <class V>
+	bool BlockingQueue<T>::PushImpl(V&& aValue, bool aWait)
+	{
+		if (aWait)
+		{
+			Spin([this] { return mySize.load(std::memory_order_relaxed) < myCapacity || myIsClosed.load(std::memory_order_relaxed); });
+		}
+
+		std::unique_lock<std::mutex> lock(myMutex);
+		if (aWait && myQueue.GetSize() >= myCapacity && !myIsClosed)
+		{
+			myWaitingProducers++;
+			myNotFull.wait(lock, [this] { return myQueue.GetSize() < myCapacity || myIsClosed; });
+			myWaitingProducers--;
+		}
+		if (myIsClosed || myQueue.GetSize() >= myCapacity)
+		{
+			return false;
+		}
+
+		myQueue.Enqueue(std::forward<V>(aValue));
+		mySize.store(myQueue.GetSize(), std::memory_order_relaxed);
+		const bool notify = myWaitingConsumers > 0;
+		lock.unlock();
+		if (notify)
+		{
+			myNotEmpty.notify_one();
+		}
+		return true;
+	}
+
+	template <class T>
+	bool BlockingQueue<T>::Pop(T& outValue)
+	{
+		return PopBatch(std::span<T>(&outValue, 1)) == 1;
+	}
+
+	template <class T>
+	bool BlockingQueue<T>::TryPop(T& outValue)
+	{
+		return TryPopBatch(std::span<T>(&outValue, 1)) == 1;
+	}
+
+	template <class T>
+	template <class Rep, class Period>
+	bool BlockingQueue<T>::PopFor(T& outValue, const std::chrono::duration<Rep, Period>& aTimeout)
+	{
+		std::unique_lock<std::mutex> lock(myMutex);
+		if (myQueue.GetSize() == 0 && !myIsClosed)
+		{
+			myWaitingConsumers++;
+			myNotEmpty.wait_for(lock, aTimeout, [this] { return myQueue.GetSize() > 0 || myIsClosed; });
+			myWaitingConsumers--;
+		}
+		return PopLocked(lock, std::span<T>(&outValue, 1)) == 1;
+	}
+
+	template <class T>
+	int BlockingQueue<T>::PopBatch(std::span<T> outValues)
+	{
+		if (outValues.empty())
+		{
+			return 0;
+		}
+		Spin([this] { return mySize.load(std::memory_order_relaxed) > 0 || myIsClosed.load(std::memory_order_relaxed); });
+
+		std::unique_lock<std::mutex> lock(myMutex);
+		if (myQueue.GetSize() == 0 && !myIsClosed)
+		{
+			myWaitingConsumers++;
+			myNotEmpty.wait(lock, [this] { return myQueue.GetSize() > 0 || myIsClosed; });
+			myWaitingConsumers--;
+		}
+		return PopLocked(lock, outValues);
+	}
+
+	template <class T>
+	int BlockingQueue<T>::TryPopBatch(std::span<T> outValues)
+	{
+		std::unique_lock<std::mutex> lock(myMutex);
+		return PopLocked(lock, outValues);
+	}
+
+	template <class T>
+	int BlockingQueue<T>::PopLocked(std::unique_lock<std::mutex>& aLock, std::span<T> outValues)
+	{
+		const int available = myQueue.GetSize();
+		const int count = (static_cast<size_t>(available) < outValues.size()) ? available : static_cast<int>(outValues.size());
+		for (int i = 0; i < count; i++)
+		{
+			outValues[i] = myQueue.Dequeue();
+		}
+		if (count == 0)
+		{
+			return 0;
+		}
+
+		mySize.store(myQueue.GetSize(), std::memory_order_relaxed);
+		const int waitingProducers = myWaitingProducers;
+		aLock.unlock();
+		// Each freed slot can let one waiting producer through
+		if (waitingProducers >= count)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				myNotFull.notify_one();
+			}
+		}
+		else if (waitingProducers > 0)
+		{
+			myNotFull.notify_all();
+		}
+		return count;
+	}
+
+	template <class T>
+	void BlockingQueue<T>::Close()
+	{
+		{
+			std::lock_guard<std::mutex> lock(myMutex);
+			myIsClosed.store(true, std::memory_order_relaxed);
+		}
+		myNotEmpty.notify_all();
+		myNotFull.notify_all();
+	}
+
+	template <class T>
+	bool BlockingQueue<T>::IsClosed() const
+	{
+		return myIsClosed.load(std::memory_order_relaxed);
+	}
+
+	template <class T>
+	int BlockingQueue<T>::GetSize() const
+	{
+		return mySize.load(std::memory_order_relaxed);
+	}
+
+	template <class T>
+	int BlockingQueue<T>::GetCapacity() const
+	{
+		return myCapacity;
+	}
+
+	template <class T>
+	template <class Condition>
+	bool BlockingQueue<T>::Spin(Condition&& aCondition) const
+	{
+		for (int i = 0; i < mySpinCount; i++)
+		{
+			if (aCondition())
+			{
+				return true;
+			}
+			// Give the other side a chance to run on an oversubscribed machine
+			if ((i & 63) == 63)
+			{
+				std::this_thread::yield();
+			}
+		}
+		return false;
+	}
+}
@@ -0,0 +1,229 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "HashMap.hpp"
+
+namespace CommonUtilities
+{
+	// Blocked Bloom filter: every key maps to one 64 byte block and sets one bit in each of its eight
+	// words, so a query reads a single cache line. Answers "definitely absent" or "maybe present",
+	// around 1% false positives at the default 10 bits per key. Keys can't be removed, Clear and re-add instead.
+	template <class Key, class Hasher = DefaultHasher<Key>>
+	class BloomFilter
+	{
+	public:
+		BloomFilter(int aExpectedCount, int aBitsPerKey = 10, const Hasher& aHasher = Hasher());
+
+		void Add(const Key& aKey);
+		bool MayContain(const Key& aKey) const;
+		void Clear();
+		// Resizes for aExpectedCount keys and clears the filter
+		void Reset(int aExpectedCount);
+
+		int GetExpectedCount() const;
+		int GetBlockCount() const;
+
+	private:
+		struct alignas(64) Block
+		{
+			uint64_t words[8];
+		};
+
+		static constexpr uint32_t mySalts[8] = { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+
+		uint64_t GetHash(const Key& aKey) const;
+		// Bit to set or test in each word of the block, picked by a different odd multiplier per word
+		static uint64_t GetMask(uint32_t aHash, int aWord);
+
+		std::vector<Block> myBlocks;
+		int myExpectedCount;
+		int myBitsPerKey;
+		Hasher myHasher;
+	};
+
+	// HashMap with a BloomFilter in front, so most lookups of missing keys are answered from the filter's
+	// small bitset without probing the table. Removed keys stay in the filter until it is rebuilt, which
+	// happens once more keys have been added since the last rebuild than the filter was sized for, so
+	// churn that keeps the map's size flat still gets the stale bits cleared.
+	template <class Key, class Value, class Hasher = DefaultHasher<Key>, class Equal = DefaultEqual<Key>, class Probing = LinearProbing, class Storage = InterleavedStorage>
+	class FilteredHashMap
+	{
+	public:
+		using MapType = HashMap<Key, Value, Hasher, Equal, Probing, Storage>;
+
+		FilteredHashMap(int aCapacity, eHashGrowth aGrowth = eHashGrowth::Rehash, float aMaxLoadFactor = 0.75f, const Hasher& aHasher = Hasher(), const Equal& aEqual = Equal());
+		FilteredHashMap(const FilteredHashMap&) = delete;
+		FilteredHashMap& operator=(const FilteredHashMap&) = delete;
+
+		bool Insert(const Key& aKey, const Value& aValue);
+		bool Remove(const Key& aKey);
+		const Value* Get(const Key& aKey) const;
+		Value* Get(const Key& aKey);
+		bool Contains(const Key& aKey) const;
+
+		// Rebuilds the filter from the map's current keys, dropping removed ones
+		void RebuildFilter();
+		int GetSize() const;
+		const MapType& GetMap() const;
+
+	private:
+		static constexpr int myMinFilterCount = 64;
+
+		MapType myMap;
+		BloomFilter<Key, Hasher> myFilter;
+		int myAddedCount;	// Keys added to the filter since it was last rebuilt, live or removed
+	};
+
+	template <class Key, class Hasher>
+	BloomFilter<Key, Hasher>::BloomFilter(int aExpectedCount, int aBitsPerKey, const Hasher& aHasher) : myBitsPerKey(aBitsPerKey < 1 ? 1 : aBitsPerKey), myHasher(aHasher)
+	{
+		Reset(aExpectedCount);
+	}
+
+	template <class Key, class Hasher>
+	void BloomFilter<Key, Hasher>::Reset(int aExpectedCount)
+	{
+		myExpectedCount = aExpectedCount < 1 ? 1 : aExpectedCount;
+		const size_t bits = static_cast<size_t>(myExpectedCount) * static_cast<size_t>(myBitsPerKey);
+		myBlocks.assign((bits + 511) / 512, Block{});
+	}
+
+	template <class Key, class Hasher>
+	uint64_t BloomFilter<Key, Hasher>::GetHash(const Key& aKey) const
+	{
+		// Spread the hasher's output over 64 bits, the high half picks the block and the low half the bits
+		return MixHash(static_cast<uint64_t>(myHasher(aKey)) ^ 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL);
+	}
+
+	template <class Key, class Hasher>
+	uint64_t BloomFilter<Key, Hasher>::GetMask(uint32_t aHash, int aWord)
+	{
+		return 1ULL << ((aHash * mySalts[aWord]) >> 26);
+	}
+
+	template <class Key, class Hasher>
+	void BloomFilter<Key, Hasher>::Add(const Key& aKey)
+	{
+		const uint64_t hash = GetHash(aKey);
+		Block& block = myBlocks[((hash >> 32) * myBlocks.size()) >> 32];
+		for (int i = 0; i < 8; i++)
+		{
+			block.words[i] |= GetMask(static_cast<uint32_t>(hash), i);
+		}
+	}
+
+	template <class Key, class Hasher>
+	bool BloomFilter<Key, Hasher>::MayContain(const Key& aKey) const
+	{
+		const uint64_t hash = GetHash(aKey);
+		const Block& block = myBlocks[((hash >> 32) * myBlocks.size()) >> 32];
+		for (int i = 0; i < 8; i++)
+		{
+			const uint64_t mask = GetMask(static_cast<uint32_t>(hash), i);
+			if ((block.words[i] & mask) != mask)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <class Key, class Hasher>
+	void BloomFilter<Key, Hasher>::Clear()
+	{
+		for (Block& block : myBlocks)
+		{
+			block = Block{};
+		}
+	}
+
+	template <class Key, class Hasher>
+	int BloomFilter<Key, Hasher>::GetExpectedCount() const
+	{
+		return myExpectedCount;
+	}
+
+	template <class Key, class Hasher>
+	int BloomFilter<Key, Hasher>::GetBlockCount() const
+	{
+		return static_cast<int>(myBlocks.size());
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::FilteredHashMap(int aCapacity, eHashGrowth aGrowth, float aMaxLoadFactor, const Hasher& aHasher, const Equal& aEqual)
+		: myMap(aCapacity, aGrowth, aMaxLoadFactor, aHasher, aEqual), myFilter(aCapacity > myMinFilterCount ? aCapacity : myMinFilterCount, 10, aHasher), myAddedCount(0)
+	{
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	bool FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::Insert(const Key& aKey, const Value& aValue)
+	{
+		const auto [value, inserted] = myMap.InsertOrAssign(aKey, aValue);
+		if (!value)
+		{
+			return false;
+		}
+		if (!inserted)
+		{
+			return true;
+		}
+
+		myAddedCount++;
+		if (myAddedCount > myFilter.GetExpectedCount())
+		{
+			RebuildFilter();
+		}
+		else
+		{
+			myFilter.Add(aKey);
+		}
+		return true;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	bool FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::Remove(const Key& aKey)
+	{
+		return myFilter.MayContain(aKey) && myMap.Remove(aKey);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	const Value* FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::Get(const Key& aKey) const
+	{
+		return myFilter.MayContain(aKey) ? myMap.Get(aKey) : nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	Value* FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::Get(const Key& aKey)
+	{
+		return myFilter.MayContain(aKey) ? myMap.Get(aKey) : nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	bool FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::Contains(const Key& aKey) const
+	{
+		return Get(aKey) != nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::RebuildFilter()
+	{
+		myFilter.Reset(myMap.GetSize() * 2 > myMinFilterCount ? myMap.GetSize() * 2 : myMinFilterCount);
+		for (auto [key, value] : myMap)
+		{
+			myFilter.Add(key);
+		}
+		myAddedCount = myMap.GetSize();
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	int FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetSize() const
+	{
+		return myMap.GetSize();
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	const typename FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::MapType& FilteredHashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetMap() const
+	{
+		return myMap;
+	}
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <stdint.h>
+#include <bit>
+#include <new>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include "HashMap.hpp"
+
+namespace CommonUtilities
+{
+	// HashMap split into independently locked shards so threads working on different keys rarely
+	// wait on each other. Readers of a shard share its lock, writers take it exclusively. Values
+	// are copied out or visited under the lock since a pointer into a shard could be invalidated
+	// by a writer at any time.
+	template <class Key, class Value, class Hasher = DefaultHasher<Key>, class Equal = DefaultEqual<Key>>
+	class ConcurrentHashMap
+	{
+	public:
+		// aShardCount is rounded up to a power of two, aCapacity is split evenly between the shards
+		ConcurrentHashMap(int aCapacity, int aShardCount = 16, const Hasher& aHasher = Hasher(), const Equal& aEqual = Equal());
+		ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+		ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+		~ConcurrentHashMap();
+
+		bool Insert(const Key& aKey, const Value& aValue);
+		// Returns false without touching aValue if aKey is already present
+		bool TryInsert(const Key& aKey, const Value& aValue);
+		bool Remove(const Key& aKey);
+		bool Contains(const Key& aKey) const;
+		// Copies the value for aKey to outValue, returns false if aKey is missing
+		bool Get(const Key& aKey, Value& outValue) const;
+
+		// Calls aVisitor with the value for aKey while holding the shard's shared lock
+		template <class Visitor>
+		bool Visit(const Key& aKey, Visitor&& aVisitor) const;
+		// Calls aVisitor with the value for aKey while holding the shard's exclusive lock
+		template <class Visitor>
+		bool Update(const Key& aKey, Visitor&& aVisitor);
+
+		int GetShardCount() const;
+
+	private:
+		// Each shard gets its own cache line so locking one never invalidates its neighbours
+		struct alignas(64) Shard
+		{
+			Shard(int aCapacity, const Hasher& aHasher, const Equal& aEqual);
+
+			mutable std::shared_mutex mutex;
+			HashMap<Key, Value, Hasher, Equal> map;
+		};
+
+		// Keys are hashed once, outside the lock. The high bits of the hash pick the shard and the whole
+		// hash is handed to the shard's HashMap, which picks slots with the low bits.
+		uint32_t Hash(const Key& aKey) const;
+		Shard& GetShard(uint32_t aHash) const;
+
+		Shard* myShards;
+		uint32_t myShardCount;
+		uint32_t myShardShift;
+		Hasher myHasher;
+	};
+
+	template <class Key, class Value, class Hasher, class Equal>
+	ConcurrentHashMap<Key, Value, Hasher, Equal>::Shard::Shard(int aCapacity, const Hasher& aHasher, const Equal& aEqual)
+		: map(aCapacity, eHashGrowth::Rehash, 0.75f, aHasher, aEqual)
+	{
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	ConcurrentHashMap<Key, Value, Hasher, Equal>::ConcurrentHashMap(int aCapacity, int aShardCount, const Hasher& aHasher, const Equal& aEqual)
+		: myHasher(aHasher)
+	{
+		myShardCount = std::bit_ceil(static_cast<uint32_t>(aShardCount > 1 ? aShardCount : 1));
+		myShardShift = 32 - std::countr_zero(myShardCount);
+
+		const int shardCapacity = static_cast<int>((static_cast<uint32_t>(aCapacity > 0 ? aCapacity : 0) + myShardCount - 1) / myShardCount);
+		myShards = static_cast<Shard*>(::operator new(sizeof(Shard) * myShardCount, std::align_val_t(alignof(Shard))));
+		for (uint32_t i = 0; i < myShardCount; i++)
+		{
+			new (&myShards[i]) Shard(shardCapacity, aHasher, aEqual);
+		}
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	ConcurrentHashMap<Key, Value, Hasher, Equal>::~ConcurrentHashMap()
+	{
+		for (uint32_t i = 0; i < myShardCount; i++)
+		{
+			myShards[i].~Shard();
+		}
+		::operator delete(myShards, std::align_val_t(alignof(Shard)));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool ConcurrentHashMap<Key, Value, Hasher, Equal>::Insert(const Key& aKey, const Value& aValue)
+	{
+		const uint32_t hash = Hash(aKey);
+		Shard& shard = GetShard(hash);
+		std::unique_lock lock(shard.mutex);
+		return shard.map.InsertOrAssignHashed(aKey, hash, aValue).first != nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool ConcurrentHashMap<Key, Value, Hasher, Equal>::TryInsert(const Key& aKey, const Value& aValue)
+	{
+		const uint32_t hash = Hash(aKey);
+		Shard& shard = GetShard(hash);
+		std::unique_lock lock(shard.mutex);
+		return shard.map.TryEmplaceHashed(aKey, hash, aValue).second;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool ConcurrentHashMap<Key, Value, Hasher, Equal>::Remove(const Key& aKey)
+	{
+		const uint32_t hash = Hash(aKey);
+		Shard& shard = GetShard(hash);
+		std::unique_lock lock(shard.mutex);
+		return shard.map.RemoveHashed(aKey, hash);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool ConcurrentHashMap<Key, Value, Hasher, Equal>::Contains(const Key& aKey) const
+	{
+		const uint32_t hash = Hash(aKey);
+		const Shard& shard = GetShard(hash);
+		std::shared_lock lock(shard.mutex);
+		return shard.map.GetHashed(aKey, hash) != nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool ConcurrentHashMap<Key, Value, Hasher, Equal>::Get(const Key& aKey, Value& outValue) const
+	{
+		return Visit(aKey, [&outValue](const Value& aValue) { outValue = aValue; });
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	template <class Visitor>
+	bool ConcurrentHashMap<Key, Value, Hasher, Equal>::Visit(const Key& aKey, Visitor&& aVisitor) const
+	{
+		const uint32_t hash = Hash(aKey);
+		const Shard& shard = GetShard(hash);
+		std::shared_lock lock(shard.mutex);
+		const Value* value = static_cast<const HashMap<Key, Value, Hasher, Equal>&>(shard.map).GetHashed(aKey, hash);
+		if (!value)
+		{
+			return false;
+		}
+		aVisitor(*value);
+		return true;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	template <class Visitor>
+	bool ConcurrentHashMap<Key, Value, Hasher, Equal>::Update(const Key& aKey, Visitor&& aVisitor)
+	{
+		const uint32_t hash = Hash(aKey);
+		Shard& shard = GetShard(hash);
+		std::unique_lock lock(shard.mutex);
+		Value* value = shard.map.GetHashed(aKey, hash);
+		if (!value)
+		{
+			return false;
+		}
+		aVisitor(*value);
+		return true;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	int ConcurrentHashMap<Key, Value, Hasher, Equal>::GetShardCount() const
+	{
+		return static_cast<int>(myShardCount);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	uint32_t ConcurrentHashMap<Key, Value, Hasher, Equal>::Hash(const Key& aKey) const
+	{
+		return static_cast<uint32_t>(myHasher(aKey));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	typename ConcurrentHashMap<Key, Value, Hasher, Equal>::Shard& ConcurrentHashMap<Key, Value, Hasher, Equal>::GetShard(uint32_t aHash) const
+	{
+		if (myShardCount == 1)
+		{
+			return myShards[0];
+		}
+		return myShards[aHash >> myShardShift];
+	}
+}
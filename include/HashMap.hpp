@@ -1,215 +1,1735 @@
 #pragma once
 #include <stdint.h>
+#include <assert.h>
+#include <bit>
+#include <functional>
+#include <iterator>
+#include <span>
 #include <vector>
 #include <string>
+#include <new>
+#include <utility>
+#include <tuple>
+#include <type_traits>
+#include "Hashers.hpp"
+
+#ifdef COMMONUTILITIES_HASHMAP_STATS
+#include "HashMapStats.hpp"
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define COMMONUTILITIES_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define COMMONUTILITIES_NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
 
 namespace CommonUtilities
 {
-	enum eHashState
+	// Hints the CPU to start loading aAddress into cache, a no-op where no hint is available
+	inline void PrefetchForRead(const void* aAddress)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(aAddress, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(static_cast<const char*>(aAddress), _MM_HINT_T0);
+#else
+		(void)aAddress;
+#endif
+	}
+
+	enum eHashState : uint8_t
 	{
 		Empty = 1 << 0,
 		InUse = 1 << 1,
 		Removed = 1 << 2,
+		Displaced = 1 << 3,	// Transient, marks InUse entries waiting to be reinserted by Compact
+	};
+
+	enum eHashGrowth
+	{
+		Fixed,				// Capacity is set once, Insert fails when the table is full
+		Rehash,				// Rehashes everything into a larger table when the max load factor is crossed
+		IncrementalRehash,	// Like Rehash, but old entries migrate a few slots per Insert/Remove
+	};
+
+	// Values that carry no data, like the one HashSet stores. Storages give them no space at all.
+	template <class Value>
+	struct IsEmptyValue : std::bool_constant<std::is_empty_v<Value> && std::is_trivial_v<Value>> {};
+
+	// Keys, values and slot metadata stored side by side in one array. A good fit for small values,
+	// since a hit brings the value into cache together with the key.
+	struct InterleavedStorage
+	{
+		template <class Key, class Value, bool UsesDistance>
+		class Slots;
+	};
+
+	// Slot metadata, keys and values kept in separate arrays, so probing only touches the state bytes
+	// and the keys it compares. A good fit for large values.
+	struct SplitStorage
+	{
+		template <class Key, class Value, bool UsesDistance>
+		class Slots;
+	};
+
+	template <class Key, class Value, bool UsesDistance>
+	class InterleavedStorage::Slots
+	{
+	public:
+		using KeyType = Key;
+		using ValueType = Value;
+
+		// Slots start out empty and unconstructed, Release destroys whatever is still in use
+		void Allocate(uint32_t aCapacity);
+		void Release(uint32_t aCapacity);
+		bool IsAllocated() const;
+
+		template <class K, class... Args>
+		void Construct(uint32_t aIndex, K&& aKey, Args&&... aArgs);
+		void Destroy(uint32_t aIndex);
+
+		eHashState GetState(uint32_t aIndex) const;
+		void SetState(uint32_t aIndex, eHashState aState);
+		uint32_t GetDistance(uint32_t aIndex) const;
+		void SetDistance(uint32_t aIndex, uint32_t aDistance);
+		const Key& GetKey(uint32_t aIndex) const;
+		Key& GetKey(uint32_t aIndex);
+		const Value& GetValue(uint32_t aIndex) const;
+		Value& GetValue(uint32_t aIndex);
+		// Prefetches what a probe starting at aIndex reads first
+		void Prefetch(uint32_t aIndex) const;
+
+	private:
+		struct Entry
+		{
+			Entry() {}
+			~Entry() {}
+
+			union { Key key; };
+			union { Value value; };
+			eHashState state;
+		};
+
+		struct KeyEntry
+		{
+			KeyEntry() {}
+			~KeyEntry() {}
+
+			union { Key key; };
+			COMMONUTILITIES_NO_UNIQUE_ADDRESS Value value;
+			eHashState state;
+		};
+
+		using BaseEntry = std::conditional_t<IsEmptyValue<Value>::value, KeyEntry, Entry>;
+
+		struct DistanceEntry : BaseEntry
+		{
+			uint32_t distance;
+		};
+
+		using EntryType = std::conditional_t<UsesDistance, DistanceEntry, BaseEntry>;
+
+		EntryType* myEntries = nullptr;
+	};
+
+	template <class Key, class Value, bool UsesDistance>
+	class SplitStorage::Slots
+	{
+	public:
+		using KeyType = Key;
+		using ValueType = Value;
+
+		// Slots start out empty and unconstructed, Release destroys whatever is still in use
+		void Allocate(uint32_t aCapacity);
+		void Release(uint32_t aCapacity);
+		bool IsAllocated() const;
+
+		template <class K, class... Args>
+		void Construct(uint32_t aIndex, K&& aKey, Args&&... aArgs);
+		void Destroy(uint32_t aIndex);
+
+		eHashState GetState(uint32_t aIndex) const;
+		void SetState(uint32_t aIndex, eHashState aState);
+		uint32_t GetDistance(uint32_t aIndex) const;
+		void SetDistance(uint32_t aIndex, uint32_t aDistance);
+		const Key& GetKey(uint32_t aIndex) const;
+		Key& GetKey(uint32_t aIndex);
+		const Value& GetValue(uint32_t aIndex) const;
+		Value& GetValue(uint32_t aIndex);
+		// Prefetches what a probe starting at aIndex reads first
+		void Prefetch(uint32_t aIndex) const;
+
+	private:
+		eHashState* myStates = nullptr;
+		uint32_t* myDistances = nullptr;
+		Key* myKeys = nullptr;
+		Value* myValues = nullptr;
+		// Empty values get no array, every slot hands out this one instead
+		COMMONUTILITIES_NO_UNIQUE_ADDRESS std::conditional_t<IsEmptyValue<Value>::value, Value, std::tuple<>> myEmptyValue;
+	};
+
+	// Linear probing, removed entries leave tombstones behind until the table is compacted
+	struct LinearProbing
+	{
+		static constexpr bool myUsesDistance = false;
+
+		template <class Table, class Key>
+		static uint32_t Find(const Table& aTable, const Key& aKey);
+		template <class Table, class Key>
+		static uint32_t Find(const Table& aTable, const Key& aKey, uint32_t aHash);
+		// aHash is the table hasher's result for aKey
+		template <class Table, class K, class... Args>
+		static uint32_t Insert(Table& outTable, uint32_t aHash, K&& aKey, Args&&... aArgs);
+		template <class Table>
+		static void Erase(Table& outTable, uint32_t aIndex);
+		template <class Table>
+		static void Compact(Table& outTable);
+		// Slots a lookup of a missing key with aHash examines, for the probe stats
+		template <class Table>
+		static uint32_t GetMissProbes(const Table& aTable, uint32_t aHash);
+	};
+
+	// Robin Hood probing, entries richer than the one being inserted give up their slot,
+	// which bounds probe length variance and lets misses stop early. Erase shifts the
+	// following entries back, so no tombstones are needed.
+	struct RobinHoodProbing
+	{
+		static constexpr bool myUsesDistance = true;
+
+		template <class Table, class Key>
+		static uint32_t Find(const Table& aTable, const Key& aKey);
+		template <class Table, class Key>
+		static uint32_t Find(const Table& aTable, const Key& aKey, uint32_t aHash);
+		// aHash is the table hasher's result for aKey
+		template <class Table, class K, class... Args>
+		static uint32_t Insert(Table& outTable, uint32_t aHash, K&& aKey, Args&&... aArgs);
+		template <class Table>
+		static void Erase(Table& outTable, uint32_t aIndex);
+		template <class Table>
+		static void Compact(Table& outTable);
+		// Slots a lookup of a missing key with aHash examines, for the probe stats
+		template <class Table>
+		static uint32_t GetMissProbes(const Table& aTable, uint32_t aHash);
 	};
 
-	template <class Key, class Value>
+	// Lookups with a key of another type (e.g. std::string_view into a std::string keyed map) are
+	// allowed when both the hasher and the key comparison declare themselves transparent
+	template <class Hasher, class Equal>
+	concept TransparentLookup = requires { typename Hasher::is_transparent; typename Equal::is_transparent; };
+
+	template <class Key, class Value, class Hasher = DefaultHasher<Key>, class Equal = DefaultEqual<Key>, class Probing = LinearProbing, class Storage = InterleavedStorage>
 	class HashMap
 	{
+		struct Table;
+
 	public:
-		HashMap(int aCapacity);
+		// Walks the entries of the map in slot order. Any Insert, Remove or Compact invalidates it,
+		// since those can move entries between slots or tables.
+		template <bool IsConst>
+		class Iterator
+		{
+		public:
+			using MapType = std::conditional_t<IsConst, const HashMap, HashMap>;
+			using ValueRef = std::conditional_t<IsConst, const Value&, Value&>;
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = std::pair<const Key&, ValueRef>;
+			using reference = value_type;
+
+			Iterator() = default;
+			Iterator(MapType* aMap, bool aInOldTable, uint32_t aIndex);
+			operator Iterator<true>() const;
+
+			const Key& GetKey() const;
+			ValueRef GetValue() const;
+			value_type operator*() const;
+			Iterator& operator++();
+			Iterator operator++(int);
+			bool operator==(const Iterator& aIterator) const;
+
+		private:
+			using TableType = std::conditional_t<IsConst, const Table, Table>;
+			TableType& GetTable() const;
+			// Moves to the first entry at or after myIndex, continuing into the old table when the current one runs out
+			void SkipFree();
+
+			MapType* myMap = nullptr;
+			uint32_t myIndex = 0;
+			bool myInOldTable = true;
+		};
+
+		HashMap(int aCapacity, eHashGrowth aGrowth = eHashGrowth::Fixed, float aMaxLoadFactor = 0.75f, const Hasher& aHasher = Hasher(), const Equal& aEqual = Equal());
+		HashMap(const HashMap&) = delete;
+		HashMap& operator=(const HashMap&) = delete;
 		~HashMap();
 		bool Insert(const Key& aKey, const Value& aValue);
+
+		// Each returns the value for aKey and whether a new entry was added, or nullptr when a fixed size map is full.
+		// Emplace constructs the value in place from aArgs, or move-assigns a value built from them to an existing entry.
+		template <class... Args>
+		std::pair<Value*, bool> Emplace(const Key& aKey, Args&&... aArgs);
+		template <class... Args>
+		std::pair<Value*, bool> Emplace(Key&& aKey, Args&&... aArgs);
+		// TryEmplace leaves an existing entry alone and does not touch aArgs
+		template <class... Args>
+		std::pair<Value*, bool> TryEmplace(const Key& aKey, Args&&... aArgs);
+		template <class... Args>
+		std::pair<Value*, bool> TryEmplace(Key&& aKey, Args&&... aArgs);
+		// InsertOrAssign assigns aValue to an existing entry and constructs a new one from it otherwise
+		template <class V>
+		std::pair<Value*, bool> InsertOrAssign(const Key& aKey, V&& aValue);
+		template <class V>
+		std::pair<Value*, bool> InsertOrAssign(Key&& aKey, V&& aValue);
+
 		bool Remove(const Key& aKey);
 		const Value* Get(const Key& aKey) const;
 		Value* Get(const Key& aKey);
+		bool Contains(const Key& aKey) const;
+
+		// Looks up every key in aKeys, storing its value or nullptr at the same position in outValues.
+		// Hashes and prefetches a group of keys before probing any of them, so their cache misses overlap.
+		// Returns the number of keys found.
+		int GetBatch(std::span<const Key> aKeys, std::span<Value*> outValues);
+		int GetBatch(std::span<const Key> aKeys, std::span<const Value*> outValues) const;
+
+		// Inserts every key and value pair in [aBegin, aEnd), growing the table at most once up front.
+		// Returns the number of new entries, existing keys have their value replaced.
+		template <class InputIterator>
+		int InsertRange(InputIterator aBegin, InputIterator aEnd);
+		// Destroys every entry but keeps the current capacity
+		void Clear();
+
+		Iterator<false> begin();
+		Iterator<false> end();
+		Iterator<true> begin() const;
+		Iterator<true> end() const;
+
+		template <class K> requires TransparentLookup<Hasher, Equal>
+		bool Remove(const K& aKey);
+		template <class K> requires TransparentLookup<Hasher, Equal>
+		const Value* Get(const K& aKey) const;
+		template <class K> requires TransparentLookup<Hasher, Equal>
+		Value* Get(const K& aKey);
+		template <class K> requires TransparentLookup<Hasher, Equal>
+		bool Contains(const K& aKey) const;
+		// Returns the stored key that aKey matches, nullptr if there is none
+		template <class K> requires TransparentLookup<Hasher, Equal>
+		const Key* GetKey(const K& aKey) const;
+
+		// The same operations for callers that already hashed aKey, e.g. ConcurrentHashMap after picking a
+		// shard. aHash must be this map's Hasher applied to aKey, cast to uint32_t.
+		template <class... Args>
+		std::pair<Value*, bool> EmplaceHashed(const Key& aKey, uint32_t aHash, Args&&... aArgs);
+		template <class... Args>
+		std::pair<Value*, bool> TryEmplaceHashed(const Key& aKey, uint32_t aHash, Args&&... aArgs);
+		template <class V>
+		std::pair<Value*, bool> InsertOrAssignHashed(const Key& aKey, uint32_t aHash, V&& aValue);
+		bool RemoveHashed(const Key& aKey, uint32_t aHash);
+		const Value* GetHashed(const Key& aKey, uint32_t aHash) const;
+		Value* GetHashed(const Key& aKey, uint32_t aHash);
+
+		// Makes room for aCount entries without crossing the max load factor
+		void Reserve(int aCount);
+		// Shrinks the table to the smallest capacity that holds the current entries
+		void ShrinkToFit();
+		// Clears tombstones and rebuilds the probe chains in place, without reallocating
+		void Compact();
+
+		int GetSize() const;
+		int GetCapacity() const;
+		float GetLoadFactor() const;
+		float GetMaxLoadFactor() const;
+		void SetMaxLoadFactor(float aMaxLoadFactor);
+		float GetMaxTombstoneRatio() const;
+		void SetMaxTombstoneRatio(float aMaxTombstoneRatio);
+
+#ifdef COMMONUTILITIES_HASHMAP_STATS
+		// Probe counts since construction or the last ResetStats, along with the current size and load
+		HashMapStats GetStats() const;
+		void ResetStats();
+#endif
 
 	private:
-		struct Entry
+		struct Table : Storage::template Slots<Key, Value, Probing::myUsesDistance>
 		{
-			Key key;
-			Value value;
-			eHashState state;
+			uint32_t capacity = 0;
+			uint32_t count = 0;
+			uint32_t removed = 0;
+			Hasher hasher;
+			Equal equal;
+			// One bit per slot, set while the slot is InUse, so iteration skips free runs 64 slots at a time
+			uint64_t* occupied = nullptr;
+
+			// Hides the storage's SetState to keep the occupancy bits in step with the slot states
+			void SetState(uint32_t aIndex, eHashState aState);
+			// Returns the first InUse slot at or after aIndex, or capacity if there is none
+			uint32_t FindInUse(uint32_t aIndex) const;
 		};
 
-		const uint32_t mySize;
-		Entry* myEntries;
+		enum class eOperation
+		{
+			Get,
+			Insert,
+			Remove,
+		};
+
+		static constexpr uint32_t myInvalidIndex = UINT32_MAX;
+		static constexpr uint32_t myMinCapacity = 8;
+		static constexpr uint32_t myMigrationStep = 8;
+		static constexpr uint32_t myBatchSize = 16;
+
+		static uint32_t RoundUpToPowerOfTwo(uint32_t aValue);
+		static void Allocate(Table& outTable, uint32_t aCapacity);
+		static void Release(Table& outTable);
+		static void Retire(Table& outTable, uint32_t aIndex);
+
+		template <class K>
+		const Value* Find(const K& aKey, uint32_t aHash, eOperation aOperation = eOperation::Get) const;
+		template <class K>
+		uint32_t Hash(const K& aKey) const;
+		template <class K>
+		bool Erase(const K& aKey, uint32_t aHash);
+		template <class K, class... Args>
+		std::pair<Value*, bool> EmplaceImpl(K&& aKey, uint32_t aHash, Args&&... aArgs);
+		template <class K, class... Args>
+		std::pair<Value*, bool> TryEmplaceImpl(K&& aKey, uint32_t aHash, Args&&... aArgs);
+		template <class K, class V>
+		std::pair<Value*, bool> InsertOrAssignImpl(K&& aKey, uint32_t aHash, V&& aValue);
+		template <class K, class... Args>
+		Value* InsertNew(K&& aKey, uint32_t aHash, Args&&... aArgs);
+		// Inserts into myTable as it is, without migrating, growing or compacting first
+		template <class K, class... Args>
+		Value* Place(K&& aKey, uint32_t aHash, Args&&... aArgs);
+
+		uint32_t GetRequiredCapacity(uint32_t aCount) const;
+		void Grow();
+		void Resize(uint32_t aCapacity);
+		void Migrate(uint32_t aSlotCount);
+		// Counts a lookup of aKey that ended at aIndex, a miss if aIndex is myInvalidIndex. Does nothing without stats.
+		template <class K>
+		void RecordProbes(eOperation aOperation, const Table& aTable, const K& aKey, uint32_t aIndex) const;
+
+		Table myTable;
+		Table myOldTable;
+		uint32_t myMigrationIndex;
+		float myMaxLoadFactor;
+		float myMaxTombstoneRatio;
+		eHashGrowth myGrowth;
+#ifdef COMMONUTILITIES_HASHMAP_STATS
+		mutable HashMapStatsCounters myStats;
+#endif
 	};
 
-	template <class Key, class Value>
-	CommonUtilities::HashMap<Key, Value>::~HashMap()
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	CommonUtilities::HashMap<Key, Value, Hasher, Equal, Probing, Storage>::~HashMap()
 	{
-		delete[] myEntries;
+		Release(myTable);
+		Release(myOldTable);
 	}
 
-	uint32_t Hash(const uint8_t* aBuffer, int count)
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	uint32_t HashMap<Key, Value, Hasher, Equal, Probing, Storage>::RoundUpToPowerOfTwo(uint32_t aValue)
 	{
-		const uint32_t FNVOffsetBasis = 2166136261U;
-		const uint32_t FNVPrime = 16777619U;
-		uint32_t val = FNVOffsetBasis;
-		for (int i = 0; i < count; ++i)
+		uint32_t result = 1;
+		while (result < aValue)
 		{
-			val ^= aBuffer[i];
-			val *= FNVPrime;
+			result <<= 1;
 		}
-		return val;
+		return result;
 	}
 
-	template <class Key>
-	uint32_t Hash(const Key& aKey)
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Allocate(Table& outTable, uint32_t aCapacity)
 	{
-		return Hash(reinterpret_cast<const uint8_t*>(&aKey), sizeof(aKey));
+		outTable.Allocate(aCapacity);
+		outTable.occupied = aCapacity ? new uint64_t[(aCapacity + 63) / 64]() : nullptr;
+		outTable.capacity = aCapacity;
+		outTable.count = 0;
+		outTable.removed = 0;
 	}
 
-	uint32_t Hash(const std::string& aString)
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Release(Table& outTable)
 	{
-		return Hash(reinterpret_cast<const uint8_t*>(aString.c_str()), aString.size());
+		outTable.Release(outTable.capacity);
+		delete[] outTable.occupied;
+		outTable.occupied = nullptr;
+		outTable.capacity = 0;
+		outTable.count = 0;
+		outTable.removed = 0;
 	}
 
-	template <class Key, class Value>
-	Value* HashMap<Key, Value>::Get(const Key& aKey)
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Retire(Table& outTable, uint32_t aIndex)
 	{
-		bool loopedToFirst = false;
-		uint32_t index = Hash(aKey) % mySize;
-		uint32_t bindex = Hash(aKey) % mySize;
+		// Entries leaving a table that is being migrated become tombstones regardless of the probing
+		// policy, so the probe chains of entries that have not been migrated yet stay intact
+		outTable.Destroy(aIndex);
+		outTable.SetState(aIndex, eHashState::Removed);
+		outTable.count--;
+	}
 
-		while ((myEntries[index].key < aKey) || (aKey < myEntries[index].key))
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Table::SetState(uint32_t aIndex, eHashState aState)
+	{
+		Storage::template Slots<Key, Value, Probing::myUsesDistance>::SetState(aIndex, aState);
+		if (aState == eHashState::InUse)
 		{
-			index++;
-			if (index >= mySize)
-			{
-				index = 0;
-				loopedToFirst = true;
-				if (loopedToFirst && index == Hash(aKey) % mySize) 
-				{
-					return nullptr;
-				}
-			}
-			else if (loopedToFirst && index == Hash(aKey) % mySize)
-			{
-				return nullptr;
-			}
+			occupied[aIndex / 64] |= 1ULL << (aIndex % 64);
 		}
-		if (myEntries[index].state == eHashState::Empty)
+		else
 		{
-			return nullptr;
+			occupied[aIndex / 64] &= ~(1ULL << (aIndex % 64));
 		}
-		return &myEntries[index].value;
 	}
 
-	template <class Key, class Value>
-	const Value* HashMap<Key, Value>::Get(const Key& aKey) const
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	uint32_t HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Table::FindInUse(uint32_t aIndex) const
 	{
-		bool loopedToFirst = false;
-		uint32_t index = Hash(aKey) % mySize;
+		if (aIndex >= capacity)
+		{
+			return capacity;
+		}
 
-		while ((myEntries[index].key < aKey) || (aKey < myEntries[index].key))
+		uint32_t word = aIndex / 64;
+		uint64_t bits = occupied[word] & (~0ULL << (aIndex % 64));
+		const uint32_t wordCount = (capacity + 63) / 64;
+		while (!bits)
 		{
-			index++;
-			if (index >= mySize)
-			{
-				index = 0;
-				loopedToFirst = true;
-				if (loopedToFirst && index == Hash(aKey) % mySize)
-				{
-					return nullptr;
-				}
-			}
-			else if (loopedToFirst && index == Hash(aKey) % mySize)
+			if (++word == wordCount)
 			{
-				return nullptr;
+				return capacity;
 			}
+			bits = occupied[word];
 		}
-		if (myEntries[index].state == eHashState::Empty)
+		return word * 64 + static_cast<uint32_t>(std::countr_zero(bits));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::Iterator(MapType* aMap, bool aInOldTable, uint32_t aIndex) : myMap(aMap), myIndex(aIndex), myInOldTable(aInOldTable)
+	{
+		SkipFree();
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::operator Iterator<true>() const
+	{
+		return Iterator<true>(myMap, myInOldTable, myIndex);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	typename HashMap<Key, Value, Hasher, Equal, Probing, Storage>::template Iterator<IsConst>::TableType& HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::GetTable() const
+	{
+		return myInOldTable ? myMap->myOldTable : myMap->myTable;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::SkipFree()
+	{
+		myIndex = GetTable().FindInUse(myIndex);
+		if (myIndex == GetTable().capacity && !myInOldTable)
 		{
-			return nullptr;
+			myInOldTable = true;
+			myIndex = myMap->myOldTable.FindInUse(0);
+		}
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	const Key& HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::GetKey() const
+	{
+		return GetTable().GetKey(myIndex);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	typename HashMap<Key, Value, Hasher, Equal, Probing, Storage>::template Iterator<IsConst>::ValueRef HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::GetValue() const
+	{
+		return GetTable().GetValue(myIndex);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	typename HashMap<Key, Value, Hasher, Equal, Probing, Storage>::template Iterator<IsConst>::value_type HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::operator*() const
+	{
+		return value_type(GetKey(), GetValue());
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	typename HashMap<Key, Value, Hasher, Equal, Probing, Storage>::template Iterator<IsConst>& HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::operator++()
+	{
+		myIndex++;
+		SkipFree();
+		return *this;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	typename HashMap<Key, Value, Hasher, Equal, Probing, Storage>::template Iterator<IsConst> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::operator++(int)
+	{
+		Iterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <bool IsConst>
+	bool HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Iterator<IsConst>::operator==(const Iterator& aIterator) const
+	{
+		return myMap == aIterator.myMap && myInOldTable == aIterator.myInOldTable && myIndex == aIterator.myIndex;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	typename HashMap<Key, Value, Hasher, Equal, Probing, Storage>::template Iterator<false> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::begin()
+	{
+		return Iterator<false>(this, false, 0);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	typename HashMap<Key, Value, Hasher, Equal, Probing, Storage>::template Iterator<false> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::end()
+	{
+		return Iterator<false>(this, true, myOldTable.capacity);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	typename HashMap<Key, Value, Hasher, Equal, Probing, Storage>::template Iterator<true> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::begin() const
+	{
+		return Iterator<true>(this, false, 0);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	typename HashMap<Key, Value, Hasher, Equal, Probing, Storage>::template Iterator<true> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::end() const
+	{
+		return Iterator<true>(this, true, myOldTable.capacity);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	uint32_t HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetRequiredCapacity(uint32_t aCount) const
+	{
+		uint32_t capacity = RoundUpToPowerOfTwo(aCount < myMinCapacity ? myMinCapacity : aCount);
+		while (static_cast<float>(capacity) * myMaxLoadFactor < static_cast<float>(aCount))
+		{
+			capacity <<= 1;
 		}
-		return &myEntries[index].value;
+		return capacity;
 	}
 
-	template <class Key, class Value>
-	bool HashMap<Key, Value>::Remove(const Key& aKey)
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Grow()
 	{
-		if (!myEntries || mySize <= 0)
+		const uint32_t capacity = myTable.capacity ? myTable.capacity * 2 : myMinCapacity;
+		if (myGrowth != eHashGrowth::IncrementalRehash)
 		{
-			return false;
+			Resize(capacity);
+			return;
 		}
 
-		bool loopedToFirst = false;
-		uint32_t index = Hash(aKey) % mySize;
+		// Only one migration runs at a time, so finish the previous one before starting over
+		Migrate(myOldTable.capacity);
+		myOldTable = myTable;
+		myMigrationIndex = 0;
+		Allocate(myTable, capacity);
+	}
 
-		while (myEntries[index].key < aKey || aKey < myEntries[index].key && myEntries[index].state != eHashState::Empty)
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Resize(uint32_t aCapacity)
+	{
+		Table table = myTable;
+		Allocate(table, aCapacity);
+		for (Table* source : { &myTable, &myOldTable })
 		{
-			index++;
-			if (index >= mySize)
+			for (uint32_t i = 0; i < source->capacity; i++)
 			{
-				index = 0;
-				loopedToFirst = true;
-				if (loopedToFirst && index == Hash(aKey) % mySize)
+				if (source->GetState(i) == eHashState::InUse)
 				{
-					return nullptr;
+					const uint32_t hash = Hash(source->GetKey(i));
+					Probing::Insert(table, hash, std::move(source->GetKey(i)), std::move(source->GetValue(i)));
 				}
 			}
-			else if (loopedToFirst && index == Hash(aKey) % mySize)
+			Release(*source);
+		}
+		myTable = table;
+		myMigrationIndex = 0;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Migrate(uint32_t aSlotCount)
+	{
+		if (!myOldTable.IsAllocated())
+		{
+			return;
+		}
+
+		const uint32_t end = (myOldTable.capacity - myMigrationIndex < aSlotCount) ? myOldTable.capacity : myMigrationIndex + aSlotCount;
+		for (; myMigrationIndex < end; myMigrationIndex++)
+		{
+			if (myOldTable.GetState(myMigrationIndex) == eHashState::InUse)
 			{
-				return nullptr;
+				const uint32_t hash = Hash(myOldTable.GetKey(myMigrationIndex));
+				Probing::Insert(myTable, hash, std::move(myOldTable.GetKey(myMigrationIndex)), std::move(myOldTable.GetValue(myMigrationIndex)));
+				Retire(myOldTable, myMigrationIndex);
 			}
 		}
-		myEntries[index].key = Key();
-		myEntries[index].value = Value();
-		myEntries[index].state = eHashState::Empty;
-		return true;
+
+		if (myMigrationIndex >= myOldTable.capacity)
+		{
+			Release(myOldTable);
+			myMigrationIndex = 0;
+		}
 	}
 
-	template <class Key, class Value>
-	bool HashMap<Key, Value>::Insert(const Key& aKey, const Value& aValue)
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K>
+	const Value* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Find(const K& aKey, uint32_t aHash, [[maybe_unused]] eOperation aOperation) const
 	{
-		if (!myEntries)
+		uint32_t index = Probing::Find(myTable, aKey, aHash);
+		if (index != myInvalidIndex)
+		{
+			RecordProbes(aOperation, myTable, aKey, index);
+			return &myTable.GetValue(index);
+		}
+		index = Probing::Find(myOldTable, aKey, aHash);
+		if (index != myInvalidIndex)
 		{
-			return false;
+			RecordProbes(aOperation, myOldTable, aKey, index);
+			return &myOldTable.GetValue(index);
 		}
 
-		bool loopedToFirst = false;
-		uint32_t index = Hash(aKey) % mySize;
+		// A missing key is not a failed insert, InsertNew counts the probes of the slot it ends up in
+		if (aOperation != eOperation::Insert)
+		{
+			RecordProbes(aOperation, myTable, aKey, myInvalidIndex);
+		}
+		return nullptr;
+	}
 
-		while (myEntries[index].state != eHashState::Empty && (myEntries[index].key < aKey || aKey < myEntries[index].key))
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::RecordProbes([[maybe_unused]] eOperation aOperation, [[maybe_unused]] const Table& aTable, [[maybe_unused]] const K& aKey, [[maybe_unused]] uint32_t aIndex) const
+	{
+#ifdef COMMONUTILITIES_HASHMAP_STATS
+		HashMapStatsCounters::Operation& operation = (aOperation == eOperation::Get) ? myStats.get : (aOperation == eOperation::Insert) ? myStats.insert : myStats.remove;
+		if (aIndex == myInvalidIndex)
 		{
-			index++;
-			if (index >= mySize)
+			// A miss walks myTable and, while a migration is running, the old table too
+			const uint32_t hash = static_cast<uint32_t>(aTable.hasher(aKey));
+			uint32_t probes = Probing::GetMissProbes(myTable, hash);
+			if (myOldTable.IsAllocated())
 			{
-				index = 0;
-				loopedToFirst = true;
-				if (loopedToFirst && index == Hash(aKey) % mySize)
-				{
-					return nullptr;
-				}
+				probes += Probing::GetMissProbes(myOldTable, hash);
 			}
-			else if (loopedToFirst && index == Hash(aKey) % mySize)
+			myStats.RecordMiss(operation, probes);
+			return;
+		}
+
+		const uint32_t mask = aTable.capacity - 1;
+		const uint32_t home = aTable.hasher(aKey) & mask;
+		myStats.Record(operation, ((aIndex - home) & mask) + 1);
+#endif
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K>
+	uint32_t HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Hash(const K& aKey) const
+	{
+		return static_cast<uint32_t>(myTable.hasher(aKey));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K>
+	bool HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Erase(const K& aKey, uint32_t aHash)
+	{
+		// Migrate only once aKey is no longer needed, it may refer to a key that migrating would move
+		uint32_t index = Probing::Find(myTable, aKey, aHash);
+		if (index != myInvalidIndex)
+		{
+			RecordProbes(eOperation::Remove, myTable, aKey, index);
+			Probing::Erase(myTable, index);
+			if (static_cast<float>(myTable.capacity) * myMaxTombstoneRatio < static_cast<float>(myTable.removed))
 			{
-				return false;
+				Compact();
 			}
+			Migrate(myMigrationStep);
+			return true;
+		}
+
+		index = Probing::Find(myOldTable, aKey, aHash);
+		if (index != myInvalidIndex)
+		{
+			RecordProbes(eOperation::Remove, myOldTable, aKey, index);
+			Retire(myOldTable, index);
+			Migrate(myMigrationStep);
+			return true;
+		}
+		RecordProbes(eOperation::Remove, myTable, aKey, myInvalidIndex);
+		Migrate(myMigrationStep);
+		return false;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	Value* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Get(const Key& aKey)
+	{
+		return const_cast<Value*>(Find(aKey, Hash(aKey)));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	const Value* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Get(const Key& aKey) const
+	{
+		return Find(aKey, Hash(aKey));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K> requires TransparentLookup<Hasher, Equal>
+	Value* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Get(const K& aKey)
+	{
+		return const_cast<Value*>(Find(aKey, Hash(aKey)));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K> requires TransparentLookup<Hasher, Equal>
+	const Value* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Get(const K& aKey) const
+	{
+		return Find(aKey, Hash(aKey));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	bool HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Contains(const Key& aKey) const
+	{
+		return Find(aKey, Hash(aKey)) != nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K> requires TransparentLookup<Hasher, Equal>
+	bool HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Contains(const K& aKey) const
+	{
+		return Find(aKey, Hash(aKey)) != nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K> requires TransparentLookup<Hasher, Equal>
+	const Key* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetKey(const K& aKey) const
+	{
+		const uint32_t hash = Hash(aKey);
+		uint32_t index = Probing::Find(myTable, aKey, hash);
+		if (index != myInvalidIndex)
+		{
+			RecordProbes(eOperation::Get, myTable, aKey, index);
+			return &myTable.GetKey(index);
 		}
-		myEntries[index].key = aKey;
-		myEntries[index].value = aValue;
-		myEntries[index].state = eHashState::InUse;
-		return true;
+		index = Probing::Find(myOldTable, aKey, hash);
+		if (index != myInvalidIndex)
+		{
+			RecordProbes(eOperation::Get, myOldTable, aKey, index);
+			return &myOldTable.GetKey(index);
+		}
+		RecordProbes(eOperation::Get, myTable, aKey, myInvalidIndex);
+		return nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	bool HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Remove(const Key& aKey)
+	{
+		return Erase(aKey, Hash(aKey));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K> requires TransparentLookup<Hasher, Equal>
+	bool HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Remove(const K& aKey)
+	{
+		return Erase(aKey, Hash(aKey));
 	}
 
-	template <class Key, class Value>
-	HashMap<Key, Value>::HashMap(int aCapacity) : mySize(aCapacity)
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K, class... Args>
+	Value* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::InsertNew(K&& aKey, uint32_t aHash, Args&&... aArgs)
 	{
-		if (!mySize) 
+		const uint32_t count = myTable.count + myOldTable.count + 1;
+		const float maxCount = static_cast<float>(myTable.capacity) * myMaxLoadFactor;
+		const bool grow = myGrowth != eHashGrowth::Fixed && maxCount < static_cast<float>(count);
+		// Tombstones rather than live entries pushed us over the limit, so reclaim them instead of growing
+		const bool compact = !grow && myGrowth != eHashGrowth::Fixed && maxCount < static_cast<float>(count + myTable.removed);
+		if (!grow && !compact && !myOldTable.IsAllocated())
 		{
-			myEntries = nullptr;
+			return Place(std::forward<K>(aKey), aHash, std::forward<Args>(aArgs)...);
 		}
-		else
+
+		// Migrating, growing and compacting move entries, and aKey or aArgs may refer to one of them,
+		// e.g. Insert(aKey, *Get(aOtherKey)), so the new entry is built before the tables are touched
+		Key key(std::forward<K>(aKey));
+		Value value(std::forward<Args>(aArgs)...);
+		Migrate(myMigrationStep);
+		if (grow)
 		{
-			myEntries = new Entry[mySize];
+			Grow();
 		}
-		for (uint32_t i = 0; i < mySize; i++)
+		else if (compact)
 		{
-			myEntries[i].key = Key();
-			myEntries[i].value = Value();
-			myEntries[i].state = eHashState::Empty;
+			Compact();
+		}
+		return Place(std::move(key), aHash, std::move(value));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K, class... Args>
+	Value* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Place(K&& aKey, uint32_t aHash, Args&&... aArgs)
+	{
+		const uint32_t index = Probing::Insert(myTable, aHash, std::forward<K>(aKey), std::forward<Args>(aArgs)...);
+		if (index == myInvalidIndex)
+		{
+			RecordProbes(eOperation::Insert, myTable, aKey, index);
+			return nullptr;
+		}
+		RecordProbes(eOperation::Insert, myTable, myTable.GetKey(index), index);
+		return &myTable.GetValue(index);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K, class... Args>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::TryEmplaceImpl(K&& aKey, uint32_t aHash, Args&&... aArgs)
+	{
+		Value* value = const_cast<Value*>(Find(aKey, aHash, eOperation::Insert));
+		if (value)
+		{
+			return { value, false };
+		}
+		value = InsertNew(std::forward<K>(aKey), aHash, std::forward<Args>(aArgs)...);
+		return { value, value != nullptr };
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K, class... Args>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::EmplaceImpl(K&& aKey, uint32_t aHash, Args&&... aArgs)
+	{
+		Value* value = const_cast<Value*>(Find(aKey, aHash, eOperation::Insert));
+		if (value)
+		{
+			// Built aside first, so a throwing constructor or arguments that refer to the old value are safe
+			*value = Value(std::forward<Args>(aArgs)...);
+			return { value, false };
+		}
+		value = InsertNew(std::forward<K>(aKey), aHash, std::forward<Args>(aArgs)...);
+		return { value, value != nullptr };
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class K, class V>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::InsertOrAssignImpl(K&& aKey, uint32_t aHash, V&& aValue)
+	{
+		Value* value = const_cast<Value*>(Find(aKey, aHash, eOperation::Insert));
+		if (value)
+		{
+			*value = std::forward<V>(aValue);
+			return { value, false };
 		}
+		value = InsertNew(std::forward<K>(aKey), aHash, std::forward<V>(aValue));
+		return { value, value != nullptr };
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	bool HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Insert(const Key& aKey, const Value& aValue)
+	{
+		return InsertOrAssign(aKey, aValue).first != nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class... Args>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Emplace(const Key& aKey, Args&&... aArgs)
+	{
+		const uint32_t hash = Hash(aKey);
+		return EmplaceImpl(aKey, hash, std::forward<Args>(aArgs)...);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class... Args>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Emplace(Key&& aKey, Args&&... aArgs)
+	{
+		const uint32_t hash = Hash(aKey);
+		return EmplaceImpl(std::move(aKey), hash, std::forward<Args>(aArgs)...);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class... Args>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::TryEmplace(const Key& aKey, Args&&... aArgs)
+	{
+		const uint32_t hash = Hash(aKey);
+		return TryEmplaceImpl(aKey, hash, std::forward<Args>(aArgs)...);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class... Args>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::TryEmplace(Key&& aKey, Args&&... aArgs)
+	{
+		const uint32_t hash = Hash(aKey);
+		return TryEmplaceImpl(std::move(aKey), hash, std::forward<Args>(aArgs)...);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class V>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::InsertOrAssign(const Key& aKey, V&& aValue)
+	{
+		const uint32_t hash = Hash(aKey);
+		return InsertOrAssignImpl(aKey, hash, std::forward<V>(aValue));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class V>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::InsertOrAssign(Key&& aKey, V&& aValue)
+	{
+		const uint32_t hash = Hash(aKey);
+		return InsertOrAssignImpl(std::move(aKey), hash, std::forward<V>(aValue));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class... Args>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::EmplaceHashed(const Key& aKey, uint32_t aHash, Args&&... aArgs)
+	{
+		assert(aHash == Hash(aKey) && "EmplaceHashed was given the wrong hash.");
+		return EmplaceImpl(aKey, aHash, std::forward<Args>(aArgs)...);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class... Args>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::TryEmplaceHashed(const Key& aKey, uint32_t aHash, Args&&... aArgs)
+	{
+		assert(aHash == Hash(aKey) && "TryEmplaceHashed was given the wrong hash.");
+		return TryEmplaceImpl(aKey, aHash, std::forward<Args>(aArgs)...);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class V>
+	std::pair<Value*, bool> HashMap<Key, Value, Hasher, Equal, Probing, Storage>::InsertOrAssignHashed(const Key& aKey, uint32_t aHash, V&& aValue)
+	{
+		assert(aHash == Hash(aKey) && "InsertOrAssignHashed was given the wrong hash.");
+		return InsertOrAssignImpl(aKey, aHash, std::forward<V>(aValue));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	bool HashMap<Key, Value, Hasher, Equal, Probing, Storage>::RemoveHashed(const Key& aKey, uint32_t aHash)
+	{
+		assert(aHash == Hash(aKey) && "RemoveHashed was given the wrong hash.");
+		return Erase(aKey, aHash);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	const Value* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetHashed(const Key& aKey, uint32_t aHash) const
+	{
+		assert(aHash == Hash(aKey) && "GetHashed was given the wrong hash.");
+		return Find(aKey, aHash);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	Value* HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetHashed(const Key& aKey, uint32_t aHash)
+	{
+		return const_cast<Value*>(static_cast<const HashMap*>(this)->GetHashed(aKey, aHash));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	int HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetBatch(std::span<const Key> aKeys, std::span<Value*> outValues)
+	{
+		return static_cast<const HashMap*>(this)->GetBatch(aKeys, std::span<const Value*>(const_cast<const Value**>(outValues.data()), outValues.size()));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	int HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetBatch(std::span<const Key> aKeys, std::span<const Value*> outValues) const
+	{
+		assert(outValues.size() >= aKeys.size() && "GetBatch needs an output slot per key.");
+
+		int found = 0;
+		uint32_t hashes[myBatchSize];
+		for (size_t first = 0; first < aKeys.size(); first += myBatchSize)
+		{
+			const size_t count = (aKeys.size() - first < myBatchSize) ? aKeys.size() - first : myBatchSize;
+			for (size_t i = 0; i < count; i++)
+			{
+				hashes[i] = static_cast<uint32_t>(myTable.hasher(aKeys[first + i]));
+				if (myTable.count)
+				{
+					myTable.Prefetch(hashes[i] & (myTable.capacity - 1));
+				}
+				if (myOldTable.count)
+				{
+					myOldTable.Prefetch(hashes[i] & (myOldTable.capacity - 1));
+				}
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				const Key& key = aKeys[first + i];
+				const Value* value = nullptr;
+				uint32_t index = Probing::Find(myTable, key, hashes[i]);
+				if (index != myInvalidIndex)
+				{
+					RecordProbes(eOperation::Get, myTable, key, index);
+					value = &myTable.GetValue(index);
+				}
+				else if ((index = Probing::Find(myOldTable, key, hashes[i])) != myInvalidIndex)
+				{
+					RecordProbes(eOperation::Get, myOldTable, key, index);
+					value = &myOldTable.GetValue(index);
+				}
+				else
+				{
+					RecordProbes(eOperation::Get, myTable, key, myInvalidIndex);
+				}
+				outValues[first + i] = value;
+				found += value ? 1 : 0;
+			}
+		}
+		return found;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	template <class InputIterator>
+	int HashMap<Key, Value, Hasher, Equal, Probing, Storage>::InsertRange(InputIterator aBegin, InputIterator aEnd)
+	{
+		if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIterator>::iterator_category>)
+		{
+			if (myGrowth != eHashGrowth::Fixed)
+			{
+				Reserve(GetSize() + static_cast<int>(std::distance(aBegin, aEnd)));
+			}
+		}
+
+		int inserted = 0;
+		for (; aBegin != aEnd; ++aBegin)
+		{
+			const auto& [key, value] = *aBegin;
+			if (InsertOrAssign(key, value).second)
+			{
+				inserted++;
+			}
+		}
+		return inserted;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Clear()
+	{
+		Release(myOldTable);
+		myMigrationIndex = 0;
+		for (uint32_t i = myTable.FindInUse(0); i < myTable.capacity; i = myTable.FindInUse(i + 1))
+		{
+			myTable.Destroy(i);
+		}
+		for (uint32_t i = 0; i < myTable.capacity; i++)
+		{
+			myTable.SetState(i, eHashState::Empty);
+		}
+		myTable.count = 0;
+		myTable.removed = 0;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Reserve(int aCount)
+	{
+		const uint32_t capacity = GetRequiredCapacity(static_cast<uint32_t>(aCount));
+		if (capacity > myTable.capacity)
+		{
+			Resize(capacity);
+		}
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::ShrinkToFit()
+	{
+		const uint32_t capacity = GetRequiredCapacity(myTable.count + myOldTable.count);
+		if (capacity < myTable.capacity || myOldTable.IsAllocated())
+		{
+			Resize(capacity < myTable.capacity ? capacity : myTable.capacity);
+		}
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::Compact()
+	{
+		Probing::Compact(myTable);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	int HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetSize() const
+	{
+		return static_cast<int>(myTable.count + myOldTable.count);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	int HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetCapacity() const
+	{
+		return static_cast<int>(myTable.capacity);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	float HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetLoadFactor() const
+	{
+		if (!myTable.capacity)
+		{
+			return 0.0f;
+		}
+		return static_cast<float>(myTable.count + myOldTable.count) / static_cast<float>(myTable.capacity);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	float HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetMaxLoadFactor() const
+	{
+		return myMaxLoadFactor;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::SetMaxLoadFactor(float aMaxLoadFactor)
+	{
+		myMaxLoadFactor = (aMaxLoadFactor < 0.1f) ? 0.1f : (aMaxLoadFactor > 1.0f) ? 1.0f : aMaxLoadFactor;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	float HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetMaxTombstoneRatio() const
+	{
+		return myMaxTombstoneRatio;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::SetMaxTombstoneRatio(float aMaxTombstoneRatio)
+	{
+		myMaxTombstoneRatio = (aMaxTombstoneRatio < 0.0f) ? 0.0f : (aMaxTombstoneRatio > 1.0f) ? 1.0f : aMaxTombstoneRatio;
+	}
+
+#ifdef COMMONUTILITIES_HASHMAP_STATS
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	HashMapStats HashMap<Key, Value, Hasher, Equal, Probing, Storage>::GetStats() const
+	{
+		HashMapStats stats = myStats.GetSnapshot();
+		stats.size = myTable.count + myOldTable.count;
+		stats.capacity = myTable.capacity;
+		stats.tombstones = myTable.removed + myOldTable.removed;
+		stats.loadFactor = GetLoadFactor();
+		return stats;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	void HashMap<Key, Value, Hasher, Equal, Probing, Storage>::ResetStats()
+	{
+		myStats.Reset();
+	}
+#endif
+
+	template <class Key, class Value, class Hasher, class Equal, class Probing, class Storage>
+	HashMap<Key, Value, Hasher, Equal, Probing, Storage>::HashMap(int aCapacity, eHashGrowth aGrowth, float aMaxLoadFactor, const Hasher& aHasher, const Equal& aEqual) : myMigrationIndex(0), myMaxTombstoneRatio(0.25f), myGrowth(aGrowth)
+	{
+		myTable.hasher = aHasher;
+		myTable.equal = aEqual;
+		myOldTable.hasher = aHasher;
+		myOldTable.equal = aEqual;
+		SetMaxLoadFactor(aMaxLoadFactor);
+		Allocate(myTable, aCapacity > 0 ? RoundUpToPowerOfTwo(static_cast<uint32_t>(aCapacity)) : 0);
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void InterleavedStorage::Slots<Key, Value, UsesDistance>::Allocate(uint32_t aCapacity)
+	{
+		myEntries = aCapacity ? new EntryType[aCapacity] : nullptr;
+		for (uint32_t i = 0; i < aCapacity; i++)
+		{
+			myEntries[i].state = eHashState::Empty;
+		}
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void InterleavedStorage::Slots<Key, Value, UsesDistance>::Release(uint32_t aCapacity)
+	{
+		for (uint32_t i = 0; i < aCapacity; i++)
+		{
+			if (myEntries[i].state == eHashState::InUse)
+			{
+				Destroy(i);
+			}
+		}
+		delete[] myEntries;
+		myEntries = nullptr;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	template <class K, class... Args>
+	void InterleavedStorage::Slots<Key, Value, UsesDistance>::Construct(uint32_t aIndex, K&& aKey, Args&&... aArgs)
+	{
+		new (&myEntries[aIndex].key) Key(std::forward<K>(aKey));
+		new (&myEntries[aIndex].value) Value(std::forward<Args>(aArgs)...);
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void InterleavedStorage::Slots<Key, Value, UsesDistance>::Destroy(uint32_t aIndex)
+	{
+		myEntries[aIndex].key.~Key();
+		myEntries[aIndex].value.~Value();
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	bool InterleavedStorage::Slots<Key, Value, UsesDistance>::IsAllocated() const
+	{
+		return myEntries != nullptr;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	eHashState InterleavedStorage::Slots<Key, Value, UsesDistance>::GetState(uint32_t aIndex) const
+	{
+		return myEntries[aIndex].state;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void InterleavedStorage::Slots<Key, Value, UsesDistance>::SetState(uint32_t aIndex, eHashState aState)
+	{
+		myEntries[aIndex].state = aState;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	uint32_t InterleavedStorage::Slots<Key, Value, UsesDistance>::GetDistance(uint32_t aIndex) const
+	{
+		return myEntries[aIndex].distance;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void InterleavedStorage::Slots<Key, Value, UsesDistance>::SetDistance(uint32_t aIndex, uint32_t aDistance)
+	{
+		myEntries[aIndex].distance = aDistance;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	const Key& InterleavedStorage::Slots<Key, Value, UsesDistance>::GetKey(uint32_t aIndex) const
+	{
+		return myEntries[aIndex].key;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	Key& InterleavedStorage::Slots<Key, Value, UsesDistance>::GetKey(uint32_t aIndex)
+	{
+		return myEntries[aIndex].key;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	const Value& InterleavedStorage::Slots<Key, Value, UsesDistance>::GetValue(uint32_t aIndex) const
+	{
+		return myEntries[aIndex].value;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	Value& InterleavedStorage::Slots<Key, Value, UsesDistance>::GetValue(uint32_t aIndex)
+	{
+		return myEntries[aIndex].value;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void InterleavedStorage::Slots<Key, Value, UsesDistance>::Prefetch(uint32_t aIndex) const
+	{
+		PrefetchForRead(&myEntries[aIndex]);
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void SplitStorage::Slots<Key, Value, UsesDistance>::Allocate(uint32_t aCapacity)
+	{
+		if (!aCapacity)
+		{
+			return;
+		}
+		myStates = new eHashState[aCapacity];
+		myDistances = UsesDistance ? new uint32_t[aCapacity] : nullptr;
+		myKeys = static_cast<Key*>(::operator new(sizeof(Key) * aCapacity, std::align_val_t(alignof(Key))));
+		if constexpr (!IsEmptyValue<Value>::value)
+		{
+			myValues = static_cast<Value*>(::operator new(sizeof(Value) * aCapacity, std::align_val_t(alignof(Value))));
+		}
+		for (uint32_t i = 0; i < aCapacity; i++)
+		{
+			myStates[i] = eHashState::Empty;
+		}
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void SplitStorage::Slots<Key, Value, UsesDistance>::Release(uint32_t aCapacity)
+	{
+		if (!myStates)
+		{
+			return;
+		}
+		for (uint32_t i = 0; i < aCapacity; i++)
+		{
+			if (myStates[i] == eHashState::InUse)
+			{
+				Destroy(i);
+			}
+		}
+		delete[] myStates;
+		delete[] myDistances;
+		::operator delete(myKeys, std::align_val_t(alignof(Key)));
+		if constexpr (!IsEmptyValue<Value>::value)
+		{
+			::operator delete(myValues, std::align_val_t(alignof(Value)));
+		}
+		myStates = nullptr;
+		myDistances = nullptr;
+		myKeys = nullptr;
+		myValues = nullptr;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	template <class K, class... Args>
+	void SplitStorage::Slots<Key, Value, UsesDistance>::Construct(uint32_t aIndex, K&& aKey, Args&&... aArgs)
+	{
+		new (&myKeys[aIndex]) Key(std::forward<K>(aKey));
+		if constexpr (!IsEmptyValue<Value>::value)
+		{
+			new (&myValues[aIndex]) Value(std::forward<Args>(aArgs)...);
+		}
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void SplitStorage::Slots<Key, Value, UsesDistance>::Destroy(uint32_t aIndex)
+	{
+		myKeys[aIndex].~Key();
+		if constexpr (!IsEmptyValue<Value>::value)
+		{
+			myValues[aIndex].~Value();
+		}
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	bool SplitStorage::Slots<Key, Value, UsesDistance>::IsAllocated() const
+	{
+		return myStates != nullptr;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	eHashState SplitStorage::Slots<Key, Value, UsesDistance>::GetState(uint32_t aIndex) const
+	{
+		return myStates[aIndex];
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void SplitStorage::Slots<Key, Value, UsesDistance>::SetState(uint32_t aIndex, eHashState aState)
+	{
+		myStates[aIndex] = aState;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	uint32_t SplitStorage::Slots<Key, Value, UsesDistance>::GetDistance(uint32_t aIndex) const
+	{
+		return myDistances[aIndex];
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void SplitStorage::Slots<Key, Value, UsesDistance>::SetDistance(uint32_t aIndex, uint32_t aDistance)
+	{
+		myDistances[aIndex] = aDistance;
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	const Key& SplitStorage::Slots<Key, Value, UsesDistance>::GetKey(uint32_t aIndex) const
+	{
+		return myKeys[aIndex];
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	Key& SplitStorage::Slots<Key, Value, UsesDistance>::GetKey(uint32_t aIndex)
+	{
+		return myKeys[aIndex];
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	const Value& SplitStorage::Slots<Key, Value, UsesDistance>::GetValue(uint32_t aIndex) const
+	{
+		if constexpr (IsEmptyValue<Value>::value)
+		{
+			return myEmptyValue;
+		}
+		else
+		{
+			return myValues[aIndex];
+		}
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	Value& SplitStorage::Slots<Key, Value, UsesDistance>::GetValue(uint32_t aIndex)
+	{
+		if constexpr (IsEmptyValue<Value>::value)
+		{
+			return myEmptyValue;
+		}
+		else
+		{
+			return myValues[aIndex];
+		}
+	}
+
+	template <class Key, class Value, bool UsesDistance>
+	void SplitStorage::Slots<Key, Value, UsesDistance>::Prefetch(uint32_t aIndex) const
+	{
+		PrefetchForRead(&myStates[aIndex]);
+		PrefetchForRead(&myKeys[aIndex]);
+	}
+
+	template <class Table, class Key>
+	uint32_t LinearProbing::Find(const Table& aTable, const Key& aKey)
+	{
+		return Find(aTable, aKey, static_cast<uint32_t>(aTable.hasher(aKey)));
+	}
+
+	template <class Table, class Key>
+	uint32_t LinearProbing::Find(const Table& aTable, const Key& aKey, uint32_t aHash)
+	{
+		if (!aTable.count)
+		{
+			return UINT32_MAX;
+		}
+
+		const uint32_t mask = aTable.capacity - 1;
+		uint32_t index = aHash & mask;
+		for (uint32_t probe = 0; probe < aTable.capacity; probe++)
+		{
+			const eHashState state = aTable.GetState(index);
+			if (state == eHashState::Empty)
+			{
+				return UINT32_MAX;
+			}
+			if (state == eHashState::InUse && aTable.equal(aTable.GetKey(index), aKey))
+			{
+				return index;
+			}
+			index = (index + 1) & mask;
+		}
+		return UINT32_MAX;
+	}
+
+	template <class Table>
+	uint32_t LinearProbing::GetMissProbes(const Table& aTable, uint32_t aHash)
+	{
+		const uint32_t mask = aTable.capacity - 1;
+		uint32_t index = aHash & mask;
+		for (uint32_t probe = 0; probe < aTable.capacity; probe++)
+		{
+			if (aTable.GetState(index) == eHashState::Empty)
+			{
+				return probe + 1;
+			}
+			index = (index + 1) & mask;
+		}
+		return aTable.capacity;
+	}
+
+	template <class Table, class K, class... Args>
+	uint32_t LinearProbing::Insert(Table& outTable, uint32_t aHash, K&& aKey, Args&&... aArgs)
+	{
+		if (outTable.count >= outTable.capacity)
+		{
+			return UINT32_MAX;
+		}
+
+		const uint32_t mask = outTable.capacity - 1;
+		uint32_t index = aHash & mask;
+		while (outTable.GetState(index) == eHashState::InUse)
+		{
+			index = (index + 1) & mask;
+		}
+
+		if (outTable.GetState(index) == eHashState::Removed)
+		{
+			outTable.removed--;
+		}
+		outTable.Construct(index, std::forward<K>(aKey), std::forward<Args>(aArgs)...);
+		outTable.SetState(index, eHashState::InUse);
+		outTable.count++;
+		return index;
+	}
+
+	template <class Table>
+	void LinearProbing::Erase(Table& outTable, uint32_t aIndex)
+	{
+		outTable.Destroy(aIndex);
+		outTable.SetState(aIndex, eHashState::Removed);
+		outTable.count--;
+		outTable.removed++;
+	}
+
+	template <class Table>
+	void LinearProbing::Compact(Table& outTable)
+	{
+		if (!outTable.removed)
+		{
+			return;
+		}
+
+		for (uint32_t i = 0; i < outTable.capacity; i++)
+		{
+			outTable.SetState(i, (outTable.GetState(i) == eHashState::InUse) ? eHashState::Displaced : eHashState::Empty);
+		}
+		outTable.removed = 0;
+
+		const uint32_t mask = outTable.capacity - 1;
+		for (uint32_t i = 0; i < outTable.capacity; i++)
+		{
+			while (outTable.GetState(i) == eHashState::Displaced)
+			{
+				uint32_t index = outTable.hasher(outTable.GetKey(i)) & mask;
+				while (outTable.GetState(index) == eHashState::InUse)
+				{
+					index = (index + 1) & mask;
+				}
+
+				// The first free slot of the chain is never past i, since i itself is still free
+				if (index == i)
+				{
+					outTable.SetState(i, eHashState::InUse);
+				}
+				else if (outTable.GetState(index) == eHashState::Empty)
+				{
+					outTable.Construct(index, std::move(outTable.GetKey(i)), std::move(outTable.GetValue(i)));
+					outTable.SetState(index, eHashState::InUse);
+					outTable.Destroy(i);
+					outTable.SetState(i, eHashState::Empty);
+				}
+				else
+				{
+					// Swap with another displaced entry and keep processing whatever landed in i
+					std::swap(outTable.GetKey(i), outTable.GetKey(index));
+					std::swap(outTable.GetValue(i), outTable.GetValue(index));
+					outTable.SetState(index, eHashState::InUse);
+				}
+			}
+		}
+	}
+
+	template <class Table, class Key>
+	uint32_t RobinHoodProbing::Find(const Table& aTable, const Key& aKey)
+	{
+		return Find(aTable, aKey, static_cast<uint32_t>(aTable.hasher(aKey)));
+	}
+
+	template <class Table, class Key>
+	uint32_t RobinHoodProbing::Find(const Table& aTable, const Key& aKey, uint32_t aHash)
+	{
+		if (!aTable.count)
+		{
+			return UINT32_MAX;
+		}
+
+		const uint32_t mask = aTable.capacity - 1;
+		uint32_t index = aHash & mask;
+		for (uint32_t distance = 0; distance < aTable.capacity; distance++)
+		{
+			// A miss is certain once we reach an entry closer to its home than we are to ours
+			const eHashState state = aTable.GetState(index);
+			if (state == eHashState::Empty || aTable.GetDistance(index) < distance)
+			{
+				return UINT32_MAX;
+			}
+			if (state == eHashState::InUse && aTable.equal(aTable.GetKey(index), aKey))
+			{
+				return index;
+			}
+			index = (index + 1) & mask;
+		}
+		return UINT32_MAX;
+	}
+
+	template <class Table>
+	uint32_t RobinHoodProbing::GetMissProbes(const Table& aTable, uint32_t aHash)
+	{
+		const uint32_t mask = aTable.capacity - 1;
+		uint32_t index = aHash & mask;
+		for (uint32_t distance = 0; distance < aTable.capacity; distance++)
+		{
+			if (aTable.GetState(index) == eHashState::Empty || aTable.GetDistance(index) < distance)
+			{
+				return distance + 1;
+			}
+			index = (index + 1) & mask;
+		}
+		return aTable.capacity;
+	}
+
+	template <class Table, class K, class... Args>
+	uint32_t RobinHoodProbing::Insert(Table& outTable, uint32_t aHash, K&& aKey, Args&&... aArgs)
+	{
+		if (outTable.count >= outTable.capacity)
+		{
+			return UINT32_MAX;
+		}
+
+		const uint32_t mask = outTable.capacity - 1;
+		uint32_t index = aHash & mask;
+		uint32_t distance = 0;
+		while (outTable.GetState(index) == eHashState::InUse && outTable.GetDistance(index) >= distance)
+		{
+			index = (index + 1) & mask;
+			distance++;
+		}
+
+		const uint32_t result = index;
+		outTable.count++;
+		if (outTable.GetState(index) != eHashState::InUse)
+		{
+			outTable.Construct(index, std::forward<K>(aKey), std::forward<Args>(aArgs)...);
+			outTable.SetState(index, eHashState::InUse);
+			outTable.SetDistance(index, distance);
+			return result;
+		}
+
+		// Build the new entry before displacing anything, aKey or aArgs may refer to an entry that moves.
+		// It takes the slot from the richer entry, which is then carried further along the chain.
+		typename Table::KeyType key(std::forward<K>(aKey));
+		typename Table::ValueType value(std::forward<Args>(aArgs)...);
+		uint32_t displacedDistance = distance;
+		while (true)
+		{
+			if (outTable.GetState(index) != eHashState::InUse)
+			{
+				outTable.Construct(index, std::move(key), std::move(value));
+				outTable.SetState(index, eHashState::InUse);
+				outTable.SetDistance(index, displacedDistance);
+				return result;
+			}
+
+			const uint32_t entryDistance = outTable.GetDistance(index);
+			if (entryDistance < displacedDistance)
+			{
+				std::swap(key, outTable.GetKey(index));
+				std::swap(value, outTable.GetValue(index));
+				outTable.SetDistance(index, displacedDistance);
+				displacedDistance = entryDistance;
+			}
+			index = (index + 1) & mask;
+			displacedDistance++;
+		}
+	}
+
+	template <class Table>
+	void RobinHoodProbing::Erase(Table& outTable, uint32_t aIndex)
+	{
+		const uint32_t mask = outTable.capacity - 1;
+		uint32_t index = aIndex;
+		uint32_t next = (index + 1) & mask;
+		outTable.Destroy(index);
+		while (next != aIndex && outTable.GetState(next) == eHashState::InUse && outTable.GetDistance(next) > 0)
+		{
+			outTable.Construct(index, std::move(outTable.GetKey(next)), std::move(outTable.GetValue(next)));
+			outTable.SetDistance(index, outTable.GetDistance(next) - 1);
+			outTable.Destroy(next);
+			index = next;
+			next = (next + 1) & mask;
+		}
+
+		outTable.SetState(index, eHashState::Empty);
+		outTable.SetDistance(index, 0);
+		outTable.count--;
+	}
+
+	template <class Table>
+	void RobinHoodProbing::Compact(Table&)
+	{
+		// Backward shift deletion never leaves tombstones behind
 	}
 }
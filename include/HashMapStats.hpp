@@ -0,0 +1,155 @@
+#pragma once
+#include <stdint.h>
+#include <array>
+#include <atomic>
+#include "json/json.hpp"
+
+namespace CommonUtilities
+{
+	// Probe counts gathered by a HashMap built with COMMONUTILITIES_HASHMAP_STATS defined. A probe length
+	// is the number of slots from the key's home slot to the slot it was found in or placed in, plus one.
+	// A miss counts every slot it examined, up to the empty slot or the entry that ended the search.
+	struct HashMapStats
+	{
+		struct Operation
+		{
+			uint64_t count = 0;
+			uint64_t misses = 0;		// Lookups and removals of missing keys, and inserts into a full map
+			uint64_t totalProbes = 0;	// Summed over all calls, misses included
+			uint32_t maxProbes = 0;
+
+			float GetAverageProbes() const;
+		};
+
+		static constexpr int myHistogramSize = 32;
+
+		Operation get;
+		Operation insert;
+		Operation remove;
+		// Slot i counts probe lengths of i + 1, the last slot also counts everything longer
+		std::array<uint64_t, myHistogramSize> probeHistogram = {};
+
+		// Filled in when the stats are read, from the map's current state
+		uint32_t size = 0;
+		uint32_t capacity = 0;
+		uint32_t tombstones = 0;
+		float loadFactor = 0.0f;
+
+		nlohmann::json ToJson() const;
+	};
+
+	// The live counters behind HashMapStats. Const lookups record into them, and those may run on several
+	// threads at once (e.g. under ConcurrentHashMap's shared locks), so every counter is a relaxed atomic.
+	// A snapshot taken while other threads record is not guaranteed to be consistent across counters.
+	struct HashMapStatsCounters
+	{
+		struct Operation
+		{
+			std::atomic<uint64_t> count = 0;
+			std::atomic<uint64_t> misses = 0;
+			std::atomic<uint64_t> totalProbes = 0;
+			std::atomic<uint32_t> maxProbes = 0;
+		};
+
+		Operation get;
+		Operation insert;
+		Operation remove;
+		std::array<std::atomic<uint64_t>, HashMapStats::myHistogramSize> probeHistogram = {};
+
+		void Record(Operation& outOperation, uint32_t aProbes);
+		void RecordMiss(Operation& outOperation, uint32_t aProbes);
+		// Copies the counters, leaving the size and load fields for the map to fill in
+		HashMapStats GetSnapshot() const;
+		void Reset();
+	};
+
+	inline float HashMapStats::Operation::GetAverageProbes() const
+	{
+		return count ? static_cast<float>(totalProbes) / static_cast<float>(count) : 0.0f;
+	}
+
+	inline void HashMapStatsCounters::Record(Operation& outOperation, uint32_t aProbes)
+	{
+		outOperation.count.fetch_add(1, std::memory_order_relaxed);
+		outOperation.totalProbes.fetch_add(aProbes, std::memory_order_relaxed);
+		uint32_t maxProbes = outOperation.maxProbes.load(std::memory_order_relaxed);
+		while (aProbes > maxProbes && !outOperation.maxProbes.compare_exchange_weak(maxProbes, aProbes, std::memory_order_relaxed))
+		{
+		}
+		// Only a miss on a map with no slots at all examines none
+		if (aProbes == 0)
+		{
+			return;
+		}
+		const int bucket = (aProbes <= static_cast<uint32_t>(HashMapStats::myHistogramSize)) ? static_cast<int>(aProbes) - 1 : HashMapStats::myHistogramSize - 1;
+		probeHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void HashMapStatsCounters::RecordMiss(Operation& outOperation, uint32_t aProbes)
+	{
+		Record(outOperation, aProbes);
+		outOperation.misses.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline HashMapStats HashMapStatsCounters::GetSnapshot() const
+	{
+		auto copyOperation = [](const Operation& aOperation)
+		{
+			HashMapStats::Operation operation;
+			operation.count = aOperation.count.load(std::memory_order_relaxed);
+			operation.misses = aOperation.misses.load(std::memory_order_relaxed);
+			operation.totalProbes = aOperation.totalProbes.load(std::memory_order_relaxed);
+			operation.maxProbes = aOperation.maxProbes.load(std::memory_order_relaxed);
+			return operation;
+		};
+
+		HashMapStats stats;
+		stats.get = copyOperation(get);
+		stats.insert = copyOperation(insert);
+		stats.remove = copyOperation(remove);
+		for (int i = 0; i < HashMapStats::myHistogramSize; i++)
+		{
+			stats.probeHistogram[i] = probeHistogram[i].load(std::memory_order_relaxed);
+		}
+		return stats;
+	}
+
+	inline void HashMapStatsCounters::Reset()
+	{
+		for (Operation* operation : { &get, &insert, &remove })
+		{
+			operation->count.store(0, std::memory_order_relaxed);
+			operation->misses.store(0, std::memory_order_relaxed);
+			operation->totalProbes.store(0, std::memory_order_relaxed);
+			operation->maxProbes.store(0, std::memory_order_relaxed);
+		}
+		for (std::atomic<uint64_t>& bucket : probeHistogram)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	inline nlohmann::json HashMapStats::ToJson() const
+	{
+		auto operationToJson = [](const Operation& aOperation)
+		{
+			return nlohmann::json{
+				{ "count", aOperation.count },
+				{ "misses", aOperation.misses },
+				{ "averageProbes", aOperation.GetAverageProbes() },
+				{ "maxProbes", aOperation.maxProbes },
+			};
+		};
+
+		return nlohmann::json{
+			{ "get", operationToJson(get) },
+			{ "insert", operationToJson(insert) },
+			{ "remove", operationToJson(remove) },
+			{ "probeHistogram", probeHistogram },
+			{ "size", size },
+			{ "capacity", capacity },
+			{ "tombstones", tombstones },
+			{ "loadFactor", loadFactor },
+		};
+	}
+}
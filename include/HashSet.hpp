@@ -0,0 +1,229 @@
+#pragma once
+#include <vector>
+#include "HashMap.hpp"
+
+namespace CommonUtilities
+{
+	// Set of keys built on HashMap's probing and storage, with an empty value type so slots hold
+	// only the key and its metadata. Takes the same growth, hasher and policy options as HashMap.
+	template <class Key, class Hasher = DefaultHasher<Key>, class Equal = DefaultEqual<Key>, class Probing = LinearProbing, class Storage = InterleavedStorage>
+	class HashSet
+	{
+		struct Empty {};
+		using MapType = HashMap<Key, Empty, Hasher, Equal, Probing, Storage>;
+
+	public:
+		// Walks the keys of the set, invalidated by the same calls as HashMap's iterators
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = Key;
+			using reference = const Key&;
+
+			Iterator() = default;
+			Iterator(typename MapType::template Iterator<true> aIterator);
+
+			const Key& operator*() const;
+			const Key* operator->() const;
+			Iterator& operator++();
+			Iterator operator++(int);
+			bool operator==(const Iterator& aIterator) const;
+
+		private:
+			typename MapType::template Iterator<true> myIterator;
+		};
+
+		HashSet(int aCapacity, eHashGrowth aGrowth = eHashGrowth::Fixed, float aMaxLoadFactor = 0.75f, const Hasher& aHasher = Hasher(), const Equal& aEqual = Equal());
+		HashSet(const HashSet&) = delete;
+		HashSet& operator=(const HashSet&) = delete;
+
+		// Returns true if aKey was added, false if it was already present or a fixed size set is full
+		bool Insert(const Key& aKey);
+		bool Insert(Key&& aKey);
+		bool Remove(const Key& aKey);
+		bool Contains(const Key& aKey) const;
+		template <class K> requires TransparentLookup<Hasher, Equal>
+		bool Contains(const K& aKey) const;
+		void Clear();
+
+		// Adds every key of aSet
+		void UnionWith(const HashSet& aSet);
+		// Removes every key missing from aSet
+		void IntersectWith(const HashSet& aSet);
+		// Removes every key found in aSet
+		void DifferenceWith(const HashSet& aSet);
+
+		Iterator begin() const;
+		Iterator end() const;
+
+		void Reserve(int aCount);
+		int GetSize() const;
+		int GetCapacity() const;
+
+	private:
+		MapType myMap;
+		eHashGrowth myGrowth;
+	};
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator::Iterator(typename MapType::template Iterator<true> aIterator) : myIterator(aIterator)
+	{
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	const Key& HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator::operator*() const
+	{
+		return myIterator.GetKey();
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	const Key* HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator::operator->() const
+	{
+		return &myIterator.GetKey();
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	typename HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator& HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator::operator++()
+	{
+		++myIterator;
+		return *this;
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	typename HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator::operator++(int)
+	{
+		Iterator iterator = *this;
+		++myIterator;
+		return iterator;
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	bool HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator::operator==(const Iterator& aIterator) const
+	{
+		return myIterator == aIterator.myIterator;
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	HashSet<Key, Hasher, Equal, Probing, Storage>::HashSet(int aCapacity, eHashGrowth aGrowth, float aMaxLoadFactor, const Hasher& aHasher, const Equal& aEqual)
+		: myMap(aCapacity, aGrowth, aMaxLoadFactor, aHasher, aEqual), myGrowth(aGrowth)
+	{
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	bool HashSet<Key, Hasher, Equal, Probing, Storage>::Insert(const Key& aKey)
+	{
+		return myMap.TryEmplace(aKey).second;
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	bool HashSet<Key, Hasher, Equal, Probing, Storage>::Insert(Key&& aKey)
+	{
+		return myMap.TryEmplace(std::move(aKey)).second;
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	bool HashSet<Key, Hasher, Equal, Probing, Storage>::Remove(const Key& aKey)
+	{
+		return myMap.Remove(aKey);
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	bool HashSet<Key, Hasher, Equal, Probing, Storage>::Contains(const Key& aKey) const
+	{
+		return myMap.Contains(aKey);
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	template <class K> requires TransparentLookup<Hasher, Equal>
+	bool HashSet<Key, Hasher, Equal, Probing, Storage>::Contains(const K& aKey) const
+	{
+		return myMap.Contains(aKey);
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	void HashSet<Key, Hasher, Equal, Probing, Storage>::Clear()
+	{
+		myMap.Clear();
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	void HashSet<Key, Hasher, Equal, Probing, Storage>::UnionWith(const HashSet& aSet)
+	{
+		if (&aSet == this)
+		{
+			return;
+		}
+		if (myGrowth != eHashGrowth::Fixed)
+		{
+			Reserve(GetSize() + aSet.GetSize());
+		}
+		for (const Key& key : aSet)
+		{
+			Insert(key);
+		}
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	void HashSet<Key, Hasher, Equal, Probing, Storage>::IntersectWith(const HashSet& aSet)
+	{
+		// Removing while iterating could compact the table under the iterator, so gather the keys first
+		std::vector<Key> removed;
+		for (const Key& key : *this)
+		{
+			if (!aSet.Contains(key))
+			{
+				removed.push_back(key);
+			}
+		}
+		for (const Key& key : removed)
+		{
+			Remove(key);
+		}
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	void HashSet<Key, Hasher, Equal, Probing, Storage>::DifferenceWith(const HashSet& aSet)
+	{
+		if (&aSet == this)
+		{
+			Clear();
+			return;
+		}
+		for (const Key& key : aSet)
+		{
+			Remove(key);
+		}
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	typename HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator HashSet<Key, Hasher, Equal, Probing, Storage>::begin() const
+	{
+		return Iterator(myMap.begin());
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	typename HashSet<Key, Hasher, Equal, Probing, Storage>::Iterator HashSet<Key, Hasher, Equal, Probing, Storage>::end() const
+	{
+		return Iterator(myMap.end());
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	void HashSet<Key, Hasher, Equal, Probing, Storage>::Reserve(int aCount)
+	{
+		myMap.Reserve(aCount);
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	int HashSet<Key, Hasher, Equal, Probing, Storage>::GetSize() const
+	{
+		return myMap.GetSize();
+	}
+
+	template <class Key, class Hasher, class Equal, class Probing, class Storage>
+	int HashSet<Key, Hasher, Equal, Probing, Storage>::GetCapacity() const
+	{
+		return myMap.GetCapacity();
+	}
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <bit>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace CommonUtilities
+{
+	template <class T>
+	class Vector2;
+	template <class T>
+	class Vector3;
+	template <class T>
+	class Vector4;
+
+	inline uint32_t Hash(const uint8_t* aBuffer, int count)
+	{
+		const uint32_t FNVOffsetBasis = 2166136261U;
+		const uint32_t FNVPrime = 16777619U;
+		uint32_t val = FNVOffsetBasis;
+		for (int i = 0; i < count; ++i)
+		{
+			val ^= aBuffer[i];
+			val *= FNVPrime;
+		}
+		return val;
+	}
+
+	template <class Key>
+	uint32_t Hash(const Key& aKey)
+	{
+		return Hash(reinterpret_cast<const uint8_t*>(&aKey), sizeof(aKey));
+	}
+
+	// Every string representation hashes its characters, so std::string, std::string_view and
+	// const char* keys with the same contents produce the same hash
+	inline uint32_t Hash(std::string_view aString)
+	{
+		return Hash(reinterpret_cast<const uint8_t*>(aString.data()), static_cast<int>(aString.size()));
+	}
+
+	inline uint32_t Hash(const std::string& aString)
+	{
+		return Hash(std::string_view(aString));
+	}
+
+	inline uint32_t Hash(const char* aString)
+	{
+		return Hash(std::string_view(aString));
+	}
+
+	// Multiplies to 128 bits and folds the halves together, the core mixing step of wyhash
+	inline uint64_t MixHash(uint64_t aLeft, uint64_t aRight)
+	{
+#if defined(__SIZEOF_INT128__)
+		const __uint128_t product = static_cast<__uint128_t>(aLeft) * aRight;
+		return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+		uint64_t high;
+		const uint64_t low = _umul128(aLeft, aRight, &high);
+		return low ^ high;
+#else
+		const uint64_t leftLow = aLeft & 0xFFFFFFFF, leftHigh = aLeft >> 32;
+		const uint64_t rightLow = aRight & 0xFFFFFFFF, rightHigh = aRight >> 32;
+		const uint64_t lowLow = leftLow * rightLow, lowHigh = leftLow * rightHigh;
+		const uint64_t highLow = leftHigh * rightLow, highHigh = leftHigh * rightHigh;
+		const uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFF) + (highLow & 0xFFFFFFFF);
+		const uint64_t low = (lowLow & 0xFFFFFFFF) | (middle << 32);
+		const uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+		return low ^ high;
+#endif
+	}
+
+	inline uint32_t FoldHash(uint64_t aHash)
+	{
+		return static_cast<uint32_t>(aHash ^ (aHash >> 32));
+	}
+
+	// Byte-at-a-time FNV-1a over the key's object representation. Only correct for keys
+	// without padding bytes or pointers, prefer one of the hashers below where they apply.
+	struct FNVHash
+	{
+		using is_transparent = void;
+
+		template <class Key>
+		uint32_t operator()(const Key& aKey) const;
+		uint32_t operator()(std::string_view aString) const;
+		uint32_t operator()(const std::string& aString) const;
+		uint32_t operator()(const char* aString) const;
+	};
+
+	// Integers, enums and pointers, mixed with a single 64x64 bit multiply
+	struct IntegerHash
+	{
+		template <class Key>
+		uint32_t operator()(Key aKey) const;
+	};
+
+	// Floating point values, with -0 and +0 hashing the same since they compare equal
+	struct FloatHash
+	{
+		uint32_t operator()(float aKey) const;
+		uint32_t operator()(double aKey) const;
+	};
+
+	// Strings, read eight bytes at a time in the style of wyhash. Transparent, so string keyed
+	// maps can be searched with a std::string_view or const char* without building a std::string.
+	struct StringHash
+	{
+		using is_transparent = void;
+
+		uint32_t operator()(std::string_view aString) const;
+	};
+
+	// Vector2, Vector3 and Vector4, combining the hash of each component
+	struct VectorHash
+	{
+		template <class T>
+		uint32_t operator()(const Vector2<T>& aVector) const;
+		template <class T>
+		uint32_t operator()(const Vector3<T>& aVector) const;
+		template <class T>
+		uint32_t operator()(const Vector4<T>& aVector) const;
+
+	private:
+		template <class T>
+		static uint64_t HashComponent(const T& aComponent);
+	};
+
+	template <class Key>
+	struct IsVectorKey : std::false_type {};
+	template <class T>
+	struct IsVectorKey<Vector2<T>> : std::true_type {};
+	template <class T>
+	struct IsVectorKey<Vector3<T>> : std::true_type {};
+	template <class T>
+	struct IsVectorKey<Vector4<T>> : std::true_type {};
+
+	// Picks the hasher HashMap uses when none is given
+	template <class Key>
+	using DefaultHasher =
+		std::conditional_t<std::is_integral_v<Key> || std::is_enum_v<Key> || std::is_pointer_v<Key>, IntegerHash,
+		std::conditional_t<std::is_floating_point_v<Key>, FloatHash,
+		std::conditional_t<std::is_convertible_v<const Key&, std::string_view>, StringHash,
+		std::conditional_t<IsVectorKey<Key>::value, VectorHash, FNVHash>>>>;
+
+	// Picks the key comparison HashMap uses when none is given, transparent for string keys
+	template <class Key>
+	using DefaultEqual = std::conditional_t<std::is_convertible_v<const Key&, std::string_view> && !std::is_pointer_v<Key>, std::equal_to<>, std::equal_to<Key>>;
+
+	template <class Key>
+	uint32_t FNVHash::operator()(const Key& aKey) const
+	{
+		static_assert(std::has_unique_object_representations_v<Key>, "Key has padding or non-unique bytes, give HashMap a Hasher for it");
+		return Hash(aKey);
+	}
+
+	inline uint32_t FNVHash::operator()(std::string_view aString) const
+	{
+		return Hash(aString);
+	}
+
+	inline uint32_t FNVHash::operator()(const std::string& aString) const
+	{
+		return Hash(aString);
+	}
+
+	inline uint32_t FNVHash::operator()(const char* aString) const
+	{
+		return Hash(aString);
+	}
+
+	template <class Key>
+	uint32_t IntegerHash::operator()(Key aKey) const
+	{
+		uint64_t value;
+		if constexpr (std::is_pointer_v<Key>)
+		{
+			value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(aKey));
+		}
+		else if constexpr (std::is_enum_v<Key>)
+		{
+			value = static_cast<uint64_t>(static_cast<std::underlying_type_t<Key>>(aKey));
+		}
+		else
+		{
+			value = static_cast<uint64_t>(aKey);
+		}
+		return FoldHash(MixHash(value ^ 0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL));
+	}
+
+	inline uint32_t FloatHash::operator()(float aKey) const
+	{
+		return IntegerHash()(aKey == 0.0f ? 0u : std::bit_cast<uint32_t>(aKey));
+	}
+
+	inline uint32_t FloatHash::operator()(double aKey) const
+	{
+		return IntegerHash()(aKey == 0.0 ? 0ull : std::bit_cast<uint64_t>(aKey));
+	}
+
+	inline uint32_t StringHash::operator()(std::string_view aString) const
+	{
+		constexpr uint64_t secret0 = 0xa0761d6478bd642fULL;
+		constexpr uint64_t secret1 = 0xe7037ed1a0b428dbULL;
+		constexpr uint64_t secret2 = 0x8ebc6af09c88c6e3ULL;
+
+		auto read64 = [](const char* aData) { uint64_t value; memcpy(&value, aData, sizeof(value)); return value; };
+		auto read32 = [](const char* aData) { uint32_t value; memcpy(&value, aData, sizeof(value)); return static_cast<uint64_t>(value); };
+
+		const char* data = aString.data();
+		size_t length = aString.size();
+		uint64_t seed = secret0 ^ MixHash(secret0 ^ length, secret1);
+		uint64_t a = 0;
+		uint64_t b = 0;
+
+		if (length <= 16)
+		{
+			if (length >= 8)
+			{
+				a = read64(data);
+				b = read64(data + length - 8);
+			}
+			else if (length >= 4)
+			{
+				a = read32(data);
+				b = read32(data + length - 4);
+			}
+			else if (length > 0)
+			{
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+				a = (static_cast<uint64_t>(bytes[0]) << 16) | (static_cast<uint64_t>(bytes[length >> 1]) << 8) | bytes[length - 1];
+			}
+		}
+		else
+		{
+			const char* last = data + length;
+			while (last - data > 16)
+			{
+				seed = MixHash(read64(data) ^ secret1, read64(data + 8) ^ seed);
+				data += 16;
+			}
+			a = read64(last - 16);
+			b = read64(last - 8);
+		}
+
+		return FoldHash(MixHash(secret2 ^ aString.size(), MixHash(a ^ secret1, b ^ seed)));
+	}
+
+	template <class T>
+	uint64_t VectorHash::HashComponent(const T& aComponent)
+	{
+		if constexpr (std::is_floating_point_v<T>)
+		{
+			return FloatHash()(aComponent);
+		}
+		else
+		{
+			return DefaultHasher<T>()(aComponent);
+		}
+	}
+
+	template <class T>
+	uint32_t VectorHash::operator()(const Vector2<T>& aVector) const
+	{
+		return FoldHash(MixHash(HashComponent(aVector.x) ^ 0xa0761d6478bd642fULL, (HashComponent(aVector.y) << 32) ^ 0xe7037ed1a0b428dbULL));
+	}
+
+	template <class T>
+	uint32_t VectorHash::operator()(const Vector3<T>& aVector) const
+	{
+		const uint64_t xy = MixHash(HashComponent(aVector.x) ^ 0xa0761d6478bd642fULL, (HashComponent(aVector.y) << 32) ^ 0xe7037ed1a0b428dbULL);
+		return FoldHash(MixHash(xy, HashComponent(aVector.z) ^ 0x8ebc6af09c88c6e3ULL));
+	}
+
+	template <class T>
+	uint32_t VectorHash::operator()(const Vector4<T>& aVector) const
+	{
+		const uint64_t xy = MixHash(HashComponent(aVector.x) ^ 0xa0761d6478bd642fULL, (HashComponent(aVector.y) << 32) ^ 0xe7037ed1a0b428dbULL);
+		const uint64_t zw = MixHash(HashComponent(aVector.z) ^ 0x8ebc6af09c88c6e3ULL, (HashComponent(aVector.w) << 32) ^ 0x589965cc75374cc3ULL);
+		return FoldHash(MixHash(xy, zw));
+	}
+}
@@ -1,120 +1,242 @@
 #pragma once
 #include <assert.h>
+#include <stddef.h>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <utility>
 #include <vector>
+#include "HeapSift.hpp"
 
 namespace CommonUtilities
 {
-	template <class T>
+	// Heap with the largest element on top, as ordered by Compare (a less-than), so std::greater gives a
+	// min heap. Elements are compared by what Projection returns for them, e.g. a member pointer to order
+	// jobs by their priority field. Every node has Arity children; the default of 4 keeps a node's children
+	// in one or two cache lines and halves the tree height compared to a binary heap. Elements are only
+	// ever moved, so move-only types like std::unique_ptr work.
+	template <class T, class Compare = std::less<>, size_t Arity = 4, class Projection = std::identity>
 	class Heap
 	{
+		static_assert(Arity >= 2, "A heap node needs at least two children");
+
 	public:
+		Heap(const Compare& aCompare = Compare(), const Projection& aProjection = Projection());
+		// Builds the heap from [aBegin, aEnd) in linear time
+		template <std::input_iterator InputIterator>
+		Heap(InputIterator aBegin, InputIterator aEnd, const Compare& aCompare = Compare(), const Projection& aProjection = Projection());
+
 		int GetSize() const;
 		void Enqueue(const T& aElement);
+		void Enqueue(T&& aElement);
+		// Constructs the element in place from aArgs
+		template <class... Args>
+		void Emplace(Args&&... aArgs);
 		const T& GetTop() const;
+		// Moves the top element out
 		T Dequeue();
+		// Makes room for aCount elements without reallocating
+		void Reserve(int aCount);
+
+		// Replaces the contents with [aBegin, aEnd), in linear time
+		template <std::input_iterator InputIterator>
+		void Assign(InputIterator aBegin, InputIterator aEnd);
+		// Enqueues [aBegin, aEnd), rebuilding the whole heap instead when that takes fewer steps
+		template <std::input_iterator InputIterator>
+		void PushRange(InputIterator aBegin, InputIterator aEnd);
+		// Dequeues up to outElements.size() elements into outElements, largest first, and returns how many.
+		// Batches that are large next to the heap are selected and sorted in one go instead of dequeued one by one.
+		int PopN(std::span<T> outElements);
 
 	private:
-		void SortChild(T& outChild, T& outParent);
+		// Floyd's method, sifting down every parent from the last one up to the root
+		void Heapify();
+		void SiftUp(size_t aIndex);
+		void SiftDown(size_t aIndex);
+		// True if aLeft belongs below aRight
+		bool IsLower(const T& aLeft, const T& aRight) const;
 
 		std::vector<T> myElements;
+		Compare myCompare;
+		Projection myProjection;
 	};
 
-	template <class T>
-	void CommonUtilities::Heap<T>::SortChild(T& outChild, T& outParent)
+	template <class T, size_t Arity = 4, class Projection = std::identity>
+	using MaxHeap = Heap<T, std::less<>, Arity, Projection>;
+
+	template <class T, size_t Arity = 4, class Projection = std::identity>
+	using MinHeap = Heap<T, std::greater<>, Arity, Projection>;
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	Heap<T, Compare, Arity, Projection>::Heap(const Compare& aCompare, const Projection& aProjection) : myCompare(aCompare), myProjection(aProjection)
 	{
-		if (outParent < outChild)
-		{
-			T temp = outParent;
-			outParent = outChild;
-			outChild = temp;
-		}
 	}
 
-	template <class T>
-	T Heap<T>::Dequeue()
+	template <class T, class Compare, size_t Arity, class Projection>
+	template <std::input_iterator InputIterator>
+	Heap<T, Compare, Arity, Projection>::Heap(InputIterator aBegin, InputIterator aEnd, const Compare& aCompare, const Projection& aProjection)
+		: myElements(aBegin, aEnd), myCompare(aCompare), myProjection(aProjection)
 	{
-		short index = 0;
-		short leftChildIndex = (2 * index + 1);
-		short rightChildIndex = (2 * index + 2);
-
-		auto returnValue = myElements[index];
-		myElements[index] = myElements.back();
-		myElements.pop_back();
+		Heapify();
+	}
 
-		bool hasLeftChild = (leftChildIndex < GetSize());
-		bool hasRightChild = (rightChildIndex < GetSize());
+	template <class T, class Compare, size_t Arity, class Projection>
+	template <std::input_iterator InputIterator>
+	void Heap<T, Compare, Arity, Projection>::Assign(InputIterator aBegin, InputIterator aEnd)
+	{
+		myElements.assign(aBegin, aEnd);
+		Heapify();
+	}
 
-		bool isSortedCorrectly = false;
+	template <class T, class Compare, size_t Arity, class Projection>
+	template <std::input_iterator InputIterator>
+	void Heap<T, Compare, Arity, Projection>::PushRange(InputIterator aBegin, InputIterator aEnd)
+	{
+		const size_t oldSize = myElements.size();
+		myElements.insert(myElements.end(), aBegin, aEnd);
+		const size_t size = myElements.size();
+		const size_t added = size - oldSize;
+
+		// Sifting each new element up costs about one step per level, heapifying about two per element
+		size_t height = 0;
+		for (size_t nodes = size; nodes > 1; nodes /= Arity)
+		{
+			height++;
+		}
+		if (added * height > 2 * size)
+		{
+			Heapify();
+			return;
+		}
+		for (size_t i = oldSize; i < size; i++)
+		{
+			SiftUp(i);
+		}
+	}
 
-		while (!isSortedCorrectly)
+	template <class T, class Compare, size_t Arity, class Projection>
+	int Heap<T, Compare, Arity, Projection>::PopN(std::span<T> outElements)
+	{
+		const size_t size = myElements.size();
+		const size_t count = (outElements.size() < size) ? outElements.size() : size;
+		// Each Dequeue sifts down the whole height, while selecting the top elements, sorting them and
+		// heapifying the rest costs a couple of steps per element, so large batches take the second route
+		size_t height = 0;
+		for (size_t nodes = size; nodes > 1; nodes /= Arity)
 		{
-			if (hasLeftChild && hasRightChild)
-			{
-				if (myElements[rightChildIndex] < myElements[leftChildIndex])
-				{
-					SortChild(myElements[leftChildIndex], myElements[index]);
-					index = leftChildIndex;
-				}
-				else
-				{
-					SortChild(myElements[rightChildIndex], myElements[index]);
-					index = rightChildIndex;
-				}
-			}
-			else if (hasLeftChild)
-			{
-				SortChild(myElements[leftChildIndex], myElements[index]);
-					index = leftChildIndex;
-			}
-			else if (hasRightChild)
+			height++;
+		}
+		if (count * height <= size)
+		{
+			for (size_t i = 0; i < count; i++)
 			{
-				SortChild(myElements[rightChildIndex], myElements[index]);
-				index = rightChildIndex;
+				outElements[i] = Dequeue();
 			}
+			return static_cast<int>(count);
+		}
 
-			leftChildIndex = (2 * index + 1);
-			rightChildIndex = (2 * index + 2);
-
-			hasLeftChild = (leftChildIndex < GetSize());
-			hasRightChild = (rightChildIndex < GetSize());
+		auto isHigher = [this](const T& aLeft, const T& aRight) { return IsLower(aRight, aLeft); };
+		const auto top = myElements.begin() + count;
+		if (count < size)
+		{
+			std::nth_element(myElements.begin(), top - 1, myElements.end(), isHigher);
+		}
+		std::sort(myElements.begin(), top, isHigher);
+		std::move(myElements.begin(), top, outElements.begin());
+		myElements.erase(myElements.begin(), top);
+		Heapify();
+		return static_cast<int>(count);
+	}
 
-			isSortedCorrectly = (!hasLeftChild && !hasRightChild) ? true : false;
+	template <class T, class Compare, size_t Arity, class Projection>
+	void Heap<T, Compare, Arity, Projection>::Heapify()
+	{
+		if (myElements.size() < 2)
+		{
+			return;
+		}
+		for (size_t i = (myElements.size() - 2) / Arity + 1; i-- > 0;)
+		{
+			SiftDown(i);
 		}
+	}
 
+	template <class T, class Compare, size_t Arity, class Projection>
+	void Heap<T, Compare, Arity, Projection>::SiftUp(size_t aIndex)
+	{
+		HeapSiftUp<Arity>(myElements, aIndex, [this](const T& aLeft, const T& aRight) { return IsLower(aLeft, aRight); }, [](size_t) {});
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void Heap<T, Compare, Arity, Projection>::SiftDown(size_t aIndex)
+	{
+		HeapSiftDown<Arity>(myElements, aIndex, [this](const T& aLeft, const T& aRight) { return IsLower(aLeft, aRight); }, [](size_t) {});
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	T Heap<T, Compare, Arity, Projection>::Dequeue()
+	{
+		assert(GetSize() > 0 && "Heap is empty.");
+
+		T returnValue = std::move(myElements.front());
+		if (myElements.size() > 1)
+		{
+			myElements.front() = std::move(myElements.back());
+			myElements.pop_back();
+			SiftDown(0);
+		}
+		else
+		{
+			myElements.pop_back();
+		}
 		return returnValue;
 	}
 
-	template <class T>
-	const T& Heap<T>::GetTop() const
+	template <class T, class Compare, size_t Arity, class Projection>
+	const T& Heap<T, Compare, Arity, Projection>::GetTop() const
 	{
-		assert(GetSize() > 0, "Heap is empty.");
+		assert(GetSize() > 0 && "Heap is empty.");
 		return myElements[0];
 	}
 
-	template <class T>
-	void Heap<T>::Enqueue(const T& aElement)
+	template <class T, class Compare, size_t Arity, class Projection>
+	void Heap<T, Compare, Arity, Projection>::Enqueue(const T& aElement)
 	{
-		myElements.emplace_back(aElement);
+		myElements.push_back(aElement);
+		SiftUp(myElements.size() - 1);
+	}
 
-		auto index = GetSize() - 1;
-		auto parentIndex = static_cast<int>((index - 1) * 0.5f);
+	template <class T, class Compare, size_t Arity, class Projection>
+	void Heap<T, Compare, Arity, Projection>::Enqueue(T&& aElement)
+	{
+		myElements.push_back(std::move(aElement));
+		SiftUp(myElements.size() - 1);
+	}
 
-		bool isSortedCorrectly = (myElements[index] < myElements[parentIndex] || !(myElements[index] < myElements[parentIndex]) && !(myElements[parentIndex] < myElements[index])) ? true : false;
-		while (!isSortedCorrectly)
-		{
-			T temp = myElements[index];
-			myElements[index] = myElements[parentIndex];
-			myElements[parentIndex] = temp;
+	template <class T, class Compare, size_t Arity, class Projection>
+	template <class... Args>
+	void Heap<T, Compare, Arity, Projection>::Emplace(Args&&... aArgs)
+	{
+		myElements.emplace_back(std::forward<Args>(aArgs)...);
+		SiftUp(myElements.size() - 1);
+	}
 
-			index = parentIndex;
-			parentIndex = static_cast<int>((index - 1) * 0.5f);
-			isSortedCorrectly = (myElements[index] < myElements[parentIndex] || !(myElements[index] < myElements[parentIndex]) && !(myElements[parentIndex] < myElements[index])) ? true : false;
-		}
+	template <class T, class Compare, size_t Arity, class Projection>
+	void Heap<T, Compare, Arity, Projection>::Reserve(int aCount)
+	{
+		myElements.reserve(static_cast<size_t>(aCount));
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	bool Heap<T, Compare, Arity, Projection>::IsLower(const T& aLeft, const T& aRight) const
+	{
+		return std::invoke(myCompare, std::invoke(myProjection, aLeft), std::invoke(myProjection, aRight));
 	}
 
-	template <class T>
-	int Heap<T>::GetSize() const
+	template <class T, class Compare, size_t Arity, class Projection>
+	int Heap<T, Compare, Arity, Projection>::GetSize() const
 	{
-		return myElements.size();
+		return static_cast<int>(myElements.size());
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+namespace CommonUtilities
+{
+	// The sift steps shared by Heap and IndexedHeap, over an Arity-ary heap stored in outElements.
+	// Both lift the element at aIndex out and move others into the hole it leaves, so each level costs
+	// one move instead of a swap. aIsLower(aLeft, aRight) is true if aLeft belongs below aRight, and
+	// aOnPlaced(aIndex) is called for every index an element is moved into.
+	template <size_t Arity, class Element, class IsLower, class OnPlaced>
+	void HeapSiftUp(std::vector<Element>& outElements, size_t aIndex, const IsLower& aIsLower, const OnPlaced& aOnPlaced);
+	template <size_t Arity, class Element, class IsLower, class OnPlaced>
+	void HeapSiftDown(std::vector<Element>& outElements, size_t aIndex, const IsLower& aIsLower, const OnPlaced& aOnPlaced);
+
+	template <size_t Arity, class Element, class IsLower, class OnPlaced>
+	void HeapSiftUp(std::vector<Element>& outElements, size_t aIndex, const IsLower& aIsLower, const OnPlaced& aOnPlaced)
+	{
+		Element element = std::move(outElements[aIndex]);
+		while (aIndex > 0)
+		{
+			const size_t parentIndex = (aIndex - 1) / Arity;
+			if (!aIsLower(outElements[parentIndex], element))
+			{
+				break;
+			}
+			outElements[aIndex] = std::move(outElements[parentIndex]);
+			aOnPlaced(aIndex);
+			aIndex = parentIndex;
+		}
+		outElements[aIndex] = std::move(element);
+		aOnPlaced(aIndex);
+	}
+
+	template <size_t Arity, class Element, class IsLower, class OnPlaced>
+	void HeapSiftDown(std::vector<Element>& outElements, size_t aIndex, const IsLower& aIsLower, const OnPlaced& aOnPlaced)
+	{
+		const size_t size = outElements.size();
+		Element element = std::move(outElements[aIndex]);
+		while (true)
+		{
+			const size_t firstChildIndex = aIndex * Arity + 1;
+			if (firstChildIndex >= size)
+			{
+				break;
+			}
+
+			const size_t lastChildIndex = (size - firstChildIndex < Arity) ? size : firstChildIndex + Arity;
+			size_t childIndex = firstChildIndex;
+			for (size_t i = firstChildIndex + 1; i < lastChildIndex; i++)
+			{
+				if (aIsLower(outElements[childIndex], outElements[i]))
+				{
+					childIndex = i;
+				}
+			}
+
+			if (!aIsLower(element, outElements[childIndex]))
+			{
+				break;
+			}
+			outElements[aIndex] = std::move(outElements[childIndex]);
+			aOnPlaced(aIndex);
+			aIndex = childIndex;
+		}
+		outElements[aIndex] = std::move(element);
+		aOnPlaced(aIndex);
+	}
+}
@@ -0,0 +1,276 @@
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "HeapSift.hpp"
+
+namespace CommonUtilities
+{
+	// Heap that hands out a handle for every element and tracks where each one sits, so an element can be
+	// re-prioritized or removed in O(log n) instead of being left behind as a stale entry. Ordered like Heap:
+	// the largest element under Compare on top, compared by what Projection returns for them. Elements are
+	// only ever moved, so move-only types work.
+	template <class T, class Compare = std::less<>, size_t Arity = 4, class Projection = std::identity>
+	class IndexedHeap
+	{
+		static_assert(Arity >= 2, "A heap node needs at least two children");
+
+	public:
+		using Handle = uint32_t;
+
+		IndexedHeap(const Compare& aCompare = Compare(), const Projection& aProjection = Projection());
+
+		int GetSize() const;
+		Handle Enqueue(const T& aElement);
+		Handle Enqueue(T&& aElement);
+		// Constructs the element from aArgs
+		template <class... Args>
+		Handle Emplace(Args&&... aArgs);
+		const T& GetTop() const;
+		Handle GetTopHandle() const;
+		// Moves the top element out
+		T Dequeue();
+		// Makes room for aCount elements without reallocating
+		void Reserve(int aCount);
+
+		// Handles stay valid until their element is dequeued or erased, after which they may be reused
+		bool Contains(Handle aHandle) const;
+		const T& Get(Handle aHandle) const;
+		// Increase and decrease are meant under Compare: IncreaseKey takes an element that Compare does not
+		// order below the current one, so it can only move toward the top, and DecreaseKey the opposite.
+		// With std::greater<> (e.g. a Dijkstra open list) Compare reverses the keys, so a shorter distance
+		// is an IncreaseKey.
+		void IncreaseKey(Handle aHandle, T aElement);
+		void DecreaseKey(Handle aHandle, T aElement);
+		// Replaces the element and works out the direction itself
+		void Update(Handle aHandle, T aElement);
+		void Erase(Handle aHandle);
+		void Clear();
+
+	private:
+		struct Node
+		{
+			T element;
+			Handle handle;
+		};
+
+		static constexpr uint32_t myInvalidPosition = UINT32_MAX;
+
+		Handle AllocateHandle();
+		// Appends aNode and sifts it up to where it belongs
+		Handle Push(Node&& aNode);
+		void SiftUp(size_t aIndex);
+		void SiftDown(size_t aIndex);
+		// Takes the last node out of the array and sifts it into the hole at aIndex
+		void RemoveAt(size_t aIndex);
+		// True if aLeft belongs below aRight
+		bool IsLower(const T& aLeft, const T& aRight) const;
+
+		std::vector<Node> myNodes;
+		std::vector<uint32_t> myPositions;	// Array position of every handle's node, myInvalidPosition for free handles
+		std::vector<Handle> myFreeHandles;
+		Compare myCompare;
+		Projection myProjection;
+	};
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	IndexedHeap<T, Compare, Arity, Projection>::IndexedHeap(const Compare& aCompare, const Projection& aProjection) : myCompare(aCompare), myProjection(aProjection)
+	{
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	int IndexedHeap<T, Compare, Arity, Projection>::GetSize() const
+	{
+		return static_cast<int>(myNodes.size());
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	typename IndexedHeap<T, Compare, Arity, Projection>::Handle IndexedHeap<T, Compare, Arity, Projection>::Enqueue(const T& aElement)
+	{
+		return Push(Node{ aElement, AllocateHandle() });
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	typename IndexedHeap<T, Compare, Arity, Projection>::Handle IndexedHeap<T, Compare, Arity, Projection>::Enqueue(T&& aElement)
+	{
+		return Push(Node{ std::move(aElement), AllocateHandle() });
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	template <class... Args>
+	typename IndexedHeap<T, Compare, Arity, Projection>::Handle IndexedHeap<T, Compare, Arity, Projection>::Emplace(Args&&... aArgs)
+	{
+		return Push(Node{ T(std::forward<Args>(aArgs)...), AllocateHandle() });
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	const T& IndexedHeap<T, Compare, Arity, Projection>::GetTop() const
+	{
+		assert(GetSize() > 0 && "Heap is empty.");
+		return myNodes[0].element;
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	typename IndexedHeap<T, Compare, Arity, Projection>::Handle IndexedHeap<T, Compare, Arity, Projection>::GetTopHandle() const
+	{
+		assert(GetSize() > 0 && "Heap is empty.");
+		return myNodes[0].handle;
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	T IndexedHeap<T, Compare, Arity, Projection>::Dequeue()
+	{
+		assert(GetSize() > 0 && "Heap is empty.");
+
+		T returnValue = std::move(myNodes[0].element);
+		myPositions[myNodes[0].handle] = myInvalidPosition;
+		myFreeHandles.push_back(myNodes[0].handle);
+		RemoveAt(0);
+		return returnValue;
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void IndexedHeap<T, Compare, Arity, Projection>::Reserve(int aCount)
+	{
+		myNodes.reserve(static_cast<size_t>(aCount));
+		myPositions.reserve(static_cast<size_t>(aCount));
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	bool IndexedHeap<T, Compare, Arity, Projection>::Contains(Handle aHandle) const
+	{
+		return aHandle < myPositions.size() && myPositions[aHandle] != myInvalidPosition;
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	const T& IndexedHeap<T, Compare, Arity, Projection>::Get(Handle aHandle) const
+	{
+		assert(Contains(aHandle) && "Handle is not in the heap.");
+		return myNodes[myPositions[aHandle]].element;
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void IndexedHeap<T, Compare, Arity, Projection>::IncreaseKey(Handle aHandle, T aElement)
+	{
+		assert(Contains(aHandle) && "Handle is not in the heap.");
+		const size_t index = myPositions[aHandle];
+		assert(!IsLower(aElement, myNodes[index].element) && "IncreaseKey was given an element Compare orders lower.");
+		myNodes[index].element = std::move(aElement);
+		SiftUp(index);
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void IndexedHeap<T, Compare, Arity, Projection>::DecreaseKey(Handle aHandle, T aElement)
+	{
+		assert(Contains(aHandle) && "Handle is not in the heap.");
+		const size_t index = myPositions[aHandle];
+		assert(!IsLower(myNodes[index].element, aElement) && "DecreaseKey was given an element Compare orders higher.");
+		myNodes[index].element = std::move(aElement);
+		SiftDown(index);
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void IndexedHeap<T, Compare, Arity, Projection>::Update(Handle aHandle, T aElement)
+	{
+		assert(Contains(aHandle) && "Handle is not in the heap.");
+		const size_t index = myPositions[aHandle];
+		const bool increased = IsLower(myNodes[index].element, aElement);
+		myNodes[index].element = std::move(aElement);
+		if (increased)
+		{
+			SiftUp(index);
+		}
+		else
+		{
+			SiftDown(index);
+		}
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void IndexedHeap<T, Compare, Arity, Projection>::Erase(Handle aHandle)
+	{
+		assert(Contains(aHandle) && "Handle is not in the heap.");
+		const size_t index = myPositions[aHandle];
+		myPositions[aHandle] = myInvalidPosition;
+		myFreeHandles.push_back(aHandle);
+		RemoveAt(index);
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void IndexedHeap<T, Compare, Arity, Projection>::Clear()
+	{
+		myNodes.clear();
+		myPositions.clear();
+		myFreeHandles.clear();
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	typename IndexedHeap<T, Compare, Arity, Projection>::Handle IndexedHeap<T, Compare, Arity, Projection>::AllocateHandle()
+	{
+		if (!myFreeHandles.empty())
+		{
+			const Handle handle = myFreeHandles.back();
+			myFreeHandles.pop_back();
+			return handle;
+		}
+		myPositions.push_back(myInvalidPosition);
+		return static_cast<Handle>(myPositions.size() - 1);
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	typename IndexedHeap<T, Compare, Arity, Projection>::Handle IndexedHeap<T, Compare, Arity, Projection>::Push(Node&& aNode)
+	{
+		const Handle handle = aNode.handle;
+		myNodes.push_back(std::move(aNode));
+		SiftUp(myNodes.size() - 1);
+		return handle;
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void IndexedHeap<T, Compare, Arity, Projection>::RemoveAt(size_t aIndex)
+	{
+		const size_t lastIndex = myNodes.size() - 1;
+		if (aIndex == lastIndex)
+		{
+			myNodes.pop_back();
+			return;
+		}
+
+		// The last node can belong above or below the hole, depending on which subtree it came from
+		myNodes[aIndex] = std::move(myNodes[lastIndex]);
+		myNodes.pop_back();
+		if (aIndex > 0 && IsLower(myNodes[(aIndex - 1) / Arity].element, myNodes[aIndex].element))
+		{
+			SiftUp(aIndex);
+		}
+		else
+		{
+			SiftDown(aIndex);
+		}
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void IndexedHeap<T, Compare, Arity, Projection>::SiftUp(size_t aIndex)
+	{
+		HeapSiftUp<Arity>(myNodes, aIndex,
+			[this](const Node& aLeft, const Node& aRight) { return IsLower(aLeft.element, aRight.element); },
+			[this](size_t aPlacedIndex) { myPositions[myNodes[aPlacedIndex].handle] = static_cast<uint32_t>(aPlacedIndex); });
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	void IndexedHeap<T, Compare, Arity, Projection>::SiftDown(size_t aIndex)
+	{
+		HeapSiftDown<Arity>(myNodes, aIndex,
+			[this](const Node& aLeft, const Node& aRight) { return IsLower(aLeft.element, aRight.element); },
+			[this](size_t aPlacedIndex) { myPositions[myNodes[aPlacedIndex].handle] = static_cast<uint32_t>(aPlacedIndex); });
+	}
+
+	template <class T, class Compare, size_t Arity, class Projection>
+	bool IndexedHeap<T, Compare, Arity, Projection>::IsLower(const T& aLeft, const T& aRight) const
+	{
+		return std::invoke(myCompare, std::invoke(myProjection, aLeft), std::invoke(myProjection, aRight));
+	}
+}
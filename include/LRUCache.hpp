@@ -0,0 +1,371 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "HashMap.hpp"
+
+namespace CommonUtilities
+{
+	// Cache that evicts the least recently used entries once their total cost passes a limit. Every entry
+	// costs 1 unless Put is given a cost, so the limit is an entry count or e.g. a byte budget. Entries live
+	// in one node array linked by index in recency order, with freed nodes reused, so Put does not allocate
+	// per entry once the array has grown to the working set. Each key is stored once, in its node; the map
+	// only holds node indices and hashes and compares the keys they refer to.
+	template <class Key, class Value, class Hasher = DefaultHasher<Key>, class Equal = DefaultEqual<Key>>
+	class LRUCache
+	{
+	public:
+		LRUCache(size_t aMaxCost, const Hasher& aHasher = Hasher(), const Equal& aEqual = Equal());
+		LRUCache(const LRUCache&) = delete;
+		LRUCache& operator=(const LRUCache&) = delete;
+
+		// Returns the value for aKey and marks it most recently used, nullptr on a miss
+		Value* Get(const Key& aKey);
+		// Returns the value for aKey without touching its recency or the hit and miss counts
+		const Value* Peek(const Key& aKey) const;
+		bool Contains(const Key& aKey) const;
+		// Adds or replaces the entry for aKey as the most recently used one, evicting others to make room.
+		// Returns false if aCost alone is over the max cost, in which case aKey is not cached.
+		bool Put(const Key& aKey, const Value& aValue, size_t aCost = 1);
+		bool Put(const Key& aKey, Value&& aValue, size_t aCost = 1);
+		bool Remove(const Key& aKey);
+		void Clear();
+
+		int GetSize() const;
+		size_t GetTotalCost() const;
+		size_t GetMaxCost() const;
+		// Evicts entries right away if the current total is over aMaxCost
+		void SetMaxCost(size_t aMaxCost);
+
+		uint64_t GetHitCount() const;
+		uint64_t GetMissCount() const;
+		void ResetCounters();
+
+	private:
+		struct Node
+		{
+			Key key;
+			Value value;
+			size_t cost;
+			uint32_t previous;
+			uint32_t next;
+		};
+
+		struct NodeIndex
+		{
+			uint32_t index;
+		};
+
+		// Look up the node keys behind the map's indices, and accept plain keys for lookups
+		struct IndexHasher
+		{
+			using is_transparent = void;
+
+			size_t operator()(const Key& aKey) const;
+			size_t operator()(NodeIndex aIndex) const;
+
+			const std::vector<Node>* nodes;
+			Hasher hasher;
+		};
+
+		struct IndexEqual
+		{
+			using is_transparent = void;
+
+			bool operator()(NodeIndex aLeft, NodeIndex aRight) const;
+			bool operator()(NodeIndex aLeft, const Key& aRight) const;
+
+			const std::vector<Node>* nodes;
+			Equal equal;
+		};
+
+		struct Empty {};
+
+		static constexpr uint32_t myInvalidIndex = UINT32_MAX;
+
+		template <class V>
+		bool PutImpl(const Key& aKey, V&& aValue, size_t aCost);
+		void Link(uint32_t aIndex);
+		void Unlink(uint32_t aIndex);
+		void Free(uint32_t aIndex);
+		void EvictTo(size_t aMaxCost);
+
+		HashMap<NodeIndex, Empty, IndexHasher, IndexEqual> myIndices;
+		std::vector<Node> myNodes;
+		uint32_t myHead;		// Most recently used
+		uint32_t myTail;		// Least recently used, next to be evicted
+		uint32_t myFreeList;	// Unused nodes, chained through next
+		size_t myTotalCost;
+		size_t myMaxCost;
+		uint64_t myHits;
+		uint64_t myMisses;
+	};
+
+	template <class Key, class Value, class Hasher, class Equal>
+	LRUCache<Key, Value, Hasher, Equal>::LRUCache(size_t aMaxCost, const Hasher& aHasher, const Equal& aEqual)
+		: myIndices(0, eHashGrowth::Rehash, 0.75f, IndexHasher{ &myNodes, aHasher }, IndexEqual{ &myNodes, aEqual }), myHead(myInvalidIndex), myTail(myInvalidIndex), myFreeList(myInvalidIndex),
+		myTotalCost(0), myMaxCost(aMaxCost), myHits(0), myMisses(0)
+	{
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	Value* LRUCache<Key, Value, Hasher, Equal>::Get(const Key& aKey)
+	{
+		const NodeIndex* found = myIndices.GetKey(aKey);
+		if (!found)
+		{
+			myMisses++;
+			return nullptr;
+		}
+
+		myHits++;
+		const uint32_t index = found->index;
+		if (index != myHead)
+		{
+			Unlink(index);
+			Link(index);
+		}
+		return &myNodes[index].value;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	const Value* LRUCache<Key, Value, Hasher, Equal>::Peek(const Key& aKey) const
+	{
+		const NodeIndex* found = myIndices.GetKey(aKey);
+		return found ? &myNodes[found->index].value : nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool LRUCache<Key, Value, Hasher, Equal>::Contains(const Key& aKey) const
+	{
+		return myIndices.Contains(aKey);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool LRUCache<Key, Value, Hasher, Equal>::Put(const Key& aKey, const Value& aValue, size_t aCost)
+	{
+		return PutImpl(aKey, aValue, aCost);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool LRUCache<Key, Value, Hasher, Equal>::Put(const Key& aKey, Value&& aValue, size_t aCost)
+	{
+		return PutImpl(aKey, std::move(aValue), aCost);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	template <class V>
+	bool LRUCache<Key, Value, Hasher, Equal>::PutImpl(const Key& aKey, V&& aValue, size_t aCost)
+	{
+		if (aCost > myMaxCost)
+		{
+			Remove(aKey);
+			return false;
+		}
+
+		const NodeIndex* existing = myIndices.GetKey(aKey);
+		if (existing)
+		{
+			const uint32_t index = existing->index;
+			Node& node = myNodes[index];
+			node.value = std::forward<V>(aValue);
+			myTotalCost = myTotalCost - node.cost + aCost;
+			node.cost = aCost;
+			if (index != myHead)
+			{
+				Unlink(index);
+				Link(index);
+			}
+			EvictTo(myMaxCost);
+			return true;
+		}
+
+		// Make room first, so the node the eviction frees can hold the new entry
+		EvictTo(myMaxCost - aCost);
+
+		uint32_t index = myFreeList;
+		if (index != myInvalidIndex)
+		{
+			myFreeList = myNodes[index].next;
+			myNodes[index].key = aKey;
+			myNodes[index].value = std::forward<V>(aValue);
+			myNodes[index].cost = aCost;
+		}
+		else
+		{
+			index = static_cast<uint32_t>(myNodes.size());
+			myNodes.push_back(Node{ aKey, std::forward<V>(aValue), aCost, myInvalidIndex, myInvalidIndex });
+		}
+
+		myIndices.TryEmplace(NodeIndex{ index });
+		myTotalCost += aCost;
+		Link(index);
+		return true;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool LRUCache<Key, Value, Hasher, Equal>::Remove(const Key& aKey)
+	{
+		const NodeIndex* found = myIndices.GetKey(aKey);
+		if (!found)
+		{
+			return false;
+		}
+
+		const uint32_t removed = found->index;
+		myIndices.Remove(NodeIndex{ removed });
+		Unlink(removed);
+		Free(removed);
+		return true;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void LRUCache<Key, Value, Hasher, Equal>::Clear()
+	{
+		myIndices.Clear();
+		myNodes.clear();
+		myHead = myInvalidIndex;
+		myTail = myInvalidIndex;
+		myFreeList = myInvalidIndex;
+		myTotalCost = 0;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	int LRUCache<Key, Value, Hasher, Equal>::GetSize() const
+	{
+		return myIndices.GetSize();
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	size_t LRUCache<Key, Value, Hasher, Equal>::GetTotalCost() const
+	{
+		return myTotalCost;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	size_t LRUCache<Key, Value, Hasher, Equal>::GetMaxCost() const
+	{
+		return myMaxCost;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void LRUCache<Key, Value, Hasher, Equal>::SetMaxCost(size_t aMaxCost)
+	{
+		myMaxCost = aMaxCost;
+		EvictTo(myMaxCost);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	uint64_t LRUCache<Key, Value, Hasher, Equal>::GetHitCount() const
+	{
+		return myHits;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	uint64_t LRUCache<Key, Value, Hasher, Equal>::GetMissCount() const
+	{
+		return myMisses;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void LRUCache<Key, Value, Hasher, Equal>::ResetCounters()
+	{
+		myHits = 0;
+		myMisses = 0;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void LRUCache<Key, Value, Hasher, Equal>::Link(uint32_t aIndex)
+	{
+		Node& node = myNodes[aIndex];
+		node.previous = myInvalidIndex;
+		node.next = myHead;
+		if (myHead != myInvalidIndex)
+		{
+			myNodes[myHead].previous = aIndex;
+		}
+		else
+		{
+			myTail = aIndex;
+		}
+		myHead = aIndex;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void LRUCache<Key, Value, Hasher, Equal>::Unlink(uint32_t aIndex)
+	{
+		const Node& node = myNodes[aIndex];
+		if (node.previous != myInvalidIndex)
+		{
+			myNodes[node.previous].next = node.next;
+		}
+		else
+		{
+			myHead = node.next;
+		}
+		if (node.next != myInvalidIndex)
+		{
+			myNodes[node.next].previous = node.previous;
+		}
+		else
+		{
+			myTail = node.previous;
+		}
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void LRUCache<Key, Value, Hasher, Equal>::Free(uint32_t aIndex)
+	{
+		Node& node = myNodes[aIndex];
+		myTotalCost -= node.cost;
+		// Let go of whatever the key and value hold now rather than when the node is reused
+		if constexpr (std::is_default_constructible_v<Key>)
+		{
+			node.key = Key();
+		}
+		if constexpr (std::is_default_constructible_v<Value>)
+		{
+			node.value = Value();
+		}
+		node.next = myFreeList;
+		myFreeList = aIndex;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void LRUCache<Key, Value, Hasher, Equal>::EvictTo(size_t aMaxCost)
+	{
+		while (myTotalCost > aMaxCost && myTail != myInvalidIndex)
+		{
+			const uint32_t index = myTail;
+			myIndices.Remove(NodeIndex{ index });
+			Unlink(index);
+			Free(index);
+		}
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	size_t LRUCache<Key, Value, Hasher, Equal>::IndexHasher::operator()(const Key& aKey) const
+	{
+		return hasher(aKey);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	size_t LRUCache<Key, Value, Hasher, Equal>::IndexHasher::operator()(NodeIndex aIndex) const
+	{
+		return hasher((*nodes)[aIndex.index].key);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool LRUCache<Key, Value, Hasher, Equal>::IndexEqual::operator()(NodeIndex aLeft, NodeIndex aRight) const
+	{
+		return aLeft.index == aRight.index;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool LRUCache<Key, Value, Hasher, Equal>::IndexEqual::operator()(NodeIndex aLeft, const Key& aRight) const
+	{
+		return equal((*nodes)[aLeft.index].key, aRight);
+	}
+}
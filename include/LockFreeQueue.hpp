@@ -0,0 +1,417 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <bit>
+#include <new>
+#include <span>
+#include <utility>
+
+namespace CommonUtilities
+{
+	// Bounded queue for exactly one producer thread and one consumer thread. The capacity is rounded up to
+	// a power of two. Each side owns one index and keeps a cached copy of the other's, so the shared cache
+	// lines are only read when the queue looks full or empty.
+	template <class T>
+	class SPSCQueue
+	{
+	public:
+		SPSCQueue(int aCapacity);
+		SPSCQueue(const SPSCQueue&) = delete;
+		SPSCQueue& operator=(const SPSCQueue&) = delete;
+		~SPSCQueue();
+
+		// Producer side, return false when the queue is full
+		bool TryEnqueue(const T& aValue);
+		bool TryEnqueue(T&& aValue);
+		template <class... Args>
+		bool TryEmplace(Args&&... aArgs);
+		// Copies as many of aValues as fit, publishing them all at once, and returns how many
+		int EnqueueBatch(std::span<const T> aValues);
+
+		// Consumer side, returns false when the queue is empty
+		bool TryDequeue(T& outValue);
+		// Moves up to outValues.size() elements into outValues and returns how many
+		int DequeueBatch(std::span<T> outValues);
+
+		// Exact only while neither side is running
+		int GetSize() const;
+		int GetCapacity() const;
+
+	private:
+		T* mySlots;
+		size_t myMask;
+
+		alignas(64) std::atomic<size_t> myTail;		// Written by the producer
+		size_t myCachedHead;						// Producer's last look at myHead
+		alignas(64) std::atomic<size_t> myHead;		// Written by the consumer
+		size_t myCachedTail;						// Consumer's last look at myTail
+		alignas(64) char myPadding;					// Keeps the consumer's fields off whatever follows
+	};
+
+	// Bounded queue for any number of producer and consumer threads, after Dmitry Vyukov's design. Every
+	// slot carries a sequence number that tells threads whether it is ready to be written or read, so each
+	// operation is a single compare-and-swap on the shared index in the common case.
+	template <class T>
+	class MPMCQueue
+	{
+	public:
+		MPMCQueue(int aCapacity);
+		MPMCQueue(const MPMCQueue&) = delete;
+		MPMCQueue& operator=(const MPMCQueue&) = delete;
+		~MPMCQueue();
+
+		bool TryEnqueue(const T& aValue);
+		bool TryEnqueue(T&& aValue);
+		template <class... Args>
+		bool TryEmplace(Args&&... aArgs);
+		// Claims as many consecutive free slots as are ready, up to aValues.size(), with one compare-and-swap
+		int EnqueueBatch(std::span<const T> aValues);
+
+		bool TryDequeue(T& outValue);
+		// Claims as many consecutive filled slots as are ready, up to outValues.size(), with one compare-and-swap
+		int DequeueBatch(std::span<T> outValues);
+
+		// Approximate while other threads are running
+		int GetSize() const;
+		int GetCapacity() const;
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			alignas(T) unsigned char storage[sizeof(T)];
+
+			T* GetValue();
+		};
+
+		// Finds how many slots from the current enqueue (or dequeue) position are ready and claims them
+		size_t ClaimEnqueue(size_t aCount, size_t& outPosition);
+		size_t ClaimDequeue(size_t aCount, size_t& outPosition);
+
+		Cell* myCells;
+		size_t myMask;
+
+		alignas(64) std::atomic<size_t> myEnqueuePosition;
+		alignas(64) std::atomic<size_t> myDequeuePosition;
+		alignas(64) char myPadding;
+	};
+
+	template <class T>
+	SPSCQueue<T>::SPSCQueue(int aCapacity)
+		: myTail(0), myCachedHead(0), myHead(0), myCachedTail(0)
+	{
+		const size_t capacity = std::bit_ceil(static_cast<size_t>(aCapacity > 1 ? aCapacity : 2));
+		mySlots = static_cast<T*>(::operator new(sizeof(T) * capacity, std::align_val_t(alignof(T))));
+		myMask = capacity - 1;
+	}
+
+	template <class T>
+	SPSCQueue<T>::~SPSCQueue()
+	{
+		const size_t tail = myTail.load(std::memory_order_relaxed);
+		for (size_t head = myHead.load(std::memory_order_relaxed); head != tail; head++)
+		{
+			mySlots[head & myMask].~T();
+		}
+		::operator delete(mySlots, std::align_val_t(alignof(T)));
+	}
+
+	template <class T>
+	bool SPSCQueue<T>::TryEnqueue(const T& aValue)
+	{
+		return TryEmplace(aValue);
+	}
+
+	template <class T>
+	bool SPSCQueue<T>::TryEnqueue(T&& aValue)
+	{
+		return TryEmplace(std::move(aValue));
+	}
+
+	template <class T>
+	template <class... Args>
+	bool SPSCQueue<T>::TryEmplace(Args&&... aArgs)
+	{
+		const size_t tail = myTail.load(std::memory_order_relaxed);
+		if (tail - myCachedHead > myMask)
+		{
+			myCachedHead = myHead.load(std::memory_order_acquire);
+			if (tail - myCachedHead > myMask)
+			{
+				return false;
+			}
+		}
+
+		new (&mySlots[tail & myMask]) T(std::forward<Args>(aArgs)...);
+		myTail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	template <class T>
+	int SPSCQueue<T>::EnqueueBatch(std::span<const T> aValues)
+	{
+		const size_t tail = myTail.load(std::memory_order_relaxed);
+		size_t free = myMask + 1 - (tail - myCachedHead);
+		if (free < aValues.size())
+		{
+			myCachedHead = myHead.load(std::memory_order_acquire);
+			free = myMask + 1 - (tail - myCachedHead);
+		}
+
+		const size_t count = (aValues.size() < free) ? aValues.size() : free;
+		for (size_t i = 0; i < count; i++)
+		{
+			new (&mySlots[(tail + i) & myMask]) T(aValues[i]);
+		}
+		myTail.store(tail + count, std::memory_order_release);
+		return static_cast<int>(count);
+	}
+
+	template <class T>
+	bool SPSCQueue<T>::TryDequeue(T& outValue)
+	{
+		const size_t head = myHead.load(std::memory_order_relaxed);
+		if (head == myCachedTail)
+		{
+			myCachedTail = myTail.load(std::memory_order_acquire);
+			if (head == myCachedTail)
+			{
+				return false;
+			}
+		}
+
+		T& slot = mySlots[head & myMask];
+		outValue = std::move(slot);
+		slot.~T();
+		myHead.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	template <class T>
+	int SPSCQueue<T>::DequeueBatch(std::span<T> outValues)
+	{
+		const size_t head = myHead.load(std::memory_order_relaxed);
+		size_t available = myCachedTail - head;
+		if (available < outValues.size())
+		{
+			myCachedTail = myTail.load(std::memory_order_acquire);
+			available = myCachedTail - head;
+		}
+
+		const size_t count = (outValues.size() < available) ? outValues.size() : available;
+		for (size_t i = 0; i < count; i++)
+		{
+			T& slot = mySlots[(head + i) & myMask];
+			outValues[i] = std::move(slot);
+			slot.~T();
+		}
+		myHead.store(head + count, std::memory_order_release);
+		return static_cast<int>(count);
+	}
+
+	template <class T>
+	int SPSCQueue<T>::GetSize() const
+	{
+		return static_cast<int>(myTail.load(std::memory_order_acquire) - myHead.load(std::memory_order_acquire));
+	}
+
+	template <class T>
+	int SPSCQueue<T>::GetCapacity() const
+	{
+		return static_cast<int>(myMask + 1);
+	}
+
+	template <class T>
+	T* MPMCQueue<T>::Cell::GetValue()
+	{
+		return std::launder(reinterpret_cast<T*>(storage));
+	}
+
+	template <class T>
+	MPMCQueue<T>::MPMCQueue(int aCapacity)
+		: myEnqueuePosition(0), myDequeuePosition(0)
+	{
+		const size_t capacity = std::bit_ceil(static_cast<size_t>(aCapacity > 1 ? aCapacity : 2));
+		myCells = new Cell[capacity];
+		myMask = capacity - 1;
+		for (size_t i = 0; i < capacity; i++)
+		{
+			myCells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	template <class T>
+	MPMCQueue<T>::~MPMCQueue()
+	{
+		const size_t end = myEnqueuePosition.load(std::memory_order_relaxed);
+		for (size_t position = myDequeuePosition.load(std::memory_order_relaxed); position != end; position++)
+		{
+			myCells[position & myMask].GetValue()->~T();
+		}
+		delete[] myCells;
+	}
+
+	template <class T>
+	bool MPMCQueue<T>::TryEnqueue(const T& aValue)
+	{
+		return TryEmplace(aValue);
+	}
+
+	template <class T>
+	bool MPMCQueue<T>::TryEnqueue(T&& aValue)
+	{
+		return TryEmplace(std::move(aValue));
+	}
+
+	template <class T>
+	template <class... Args>
+	bool MPMCQueue<T>::TryEmplace(Args&&... aArgs)
+	{
+		size_t position;
+		if (!ClaimEnqueue(1, position))
+		{
+			return false;
+		}
+
+		Cell& cell = myCells[position & myMask];
+		new (cell.storage) T(std::forward<Args>(aArgs)...);
+		cell.sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	template <class T>
+	int MPMCQueue<T>::EnqueueBatch(std::span<const T> aValues)
+	{
+		size_t position;
+		const size_t count = ClaimEnqueue(aValues.size(), position);
+		for (size_t i = 0; i < count; i++)
+		{
+			Cell& cell = myCells[(position + i) & myMask];
+			new (cell.storage) T(aValues[i]);
+			cell.sequence.store(position + i + 1, std::memory_order_release);
+		}
+		return static_cast<int>(count);
+	}
+
+	template <class T>
+	bool MPMCQueue<T>::TryDequeue(T& outValue)
+	{
+		size_t position;
+		if (!ClaimDequeue(1, position))
+		{
+			return false;
+		}
+
+		Cell& cell = myCells[position & myMask];
+		outValue = std::move(*cell.GetValue());
+		cell.GetValue()->~T();
+		cell.sequence.store(position + myMask + 1, std::memory_order_release);
+		return true;
+	}
+
+	template <class T>
+	int MPMCQueue<T>::DequeueBatch(std::span<T> outValues)
+	{
+		size_t position;
+		const size_t count = ClaimDequeue(outValues.size(), position);
+		for (size_t i = 0; i < count; i++)
+		{
+			Cell& cell = myCells[(position + i) & myMask];
+			outValues[i] = std::move(*cell.GetValue());
+			cell.GetValue()->~T();
+			cell.sequence.store(position + i + myMask + 1, std::memory_order_release);
+		}
+		return static_cast<int>(count);
+	}
+
+	template <class T>
+	size_t MPMCQueue<T>::ClaimEnqueue(size_t aCount, size_t& outPosition)
+	{
+		size_t position = myEnqueuePosition.load(std::memory_order_relaxed);
+		while (aCount > 0)
+		{
+			// A slot is free for position once its sequence has caught up with it
+			size_t ready = 0;
+			while (ready < aCount && ready <= myMask)
+			{
+				const size_t sequence = myCells[(position + ready) & myMask].sequence.load(std::memory_order_acquire);
+				if (sequence != position + ready)
+				{
+					break;
+				}
+				ready++;
+			}
+
+			if (ready == 0)
+			{
+				const size_t sequence = myCells[position & myMask].sequence.load(std::memory_order_acquire);
+				if (static_cast<intptr_t>(sequence - position) < 0)
+				{
+					return 0;	// Full, the slot still holds an element from the previous lap
+				}
+				position = myEnqueuePosition.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			if (myEnqueuePosition.compare_exchange_weak(position, position + ready, std::memory_order_relaxed))
+			{
+				outPosition = position;
+				return ready;
+			}
+		}
+		return 0;
+	}
+
+	template <class T>
+	size_t MPMCQueue<T>::ClaimDequeue(size_t aCount, size_t& outPosition)
+	{
+		size_t position = myDequeuePosition.load(std::memory_order_relaxed);
+		while (aCount > 0)
+		{
+			// A slot holds an element for position once its sequence is one past it
+			size_t ready = 0;
+			while (ready < aCount && ready <= myMask)
+			{
+				const size_t sequence = myCells[(position + ready) & myMask].sequence.load(std::memory_order_acquire);
+				if (sequence != position + ready + 1)
+				{
+					break;
+				}
+				ready++;
+			}
+
+			if (ready == 0)
+			{
+				const size_t sequence = myCells[position & myMask].sequence.load(std::memory_order_acquire);
+				if (static_cast<intptr_t>(sequence - (position + 1)) < 0)
+				{
+					return 0;	// Empty, nothing has been written to this slot yet
+				}
+				position = myDequeuePosition.load(std::memory_order_relaxed);
+				continue;
+			}
+
+			if (myDequeuePosition.compare_exchange_weak(position, position + ready, std::memory_order_relaxed))
+			{
+				outPosition = position;
+				return ready;
+			}
+		}
+		return 0;
+	}
+
+	template <class T>
+	int MPMCQueue<T>::GetSize() const
+	{
+		const size_t enqueued = myEnqueuePosition.load(std::memory_order_relaxed);
+		const size_t dequeued = myDequeuePosition.load(std::memory_order_relaxed);
+		return (enqueued > dequeued) ? static_cast<int>(enqueued - dequeued) : 0;
+	}
+
+	template <class T>
+	int MPMCQueue<T>::GetCapacity() const
+	{
+		return static_cast<int>(myMask + 1);
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <stddef.h>
+
+namespace CommonUtilities
+{
+	// Read-only view of a whole file mapped into memory, pages are loaded by the OS on first touch
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile& aMappedFile) = delete;
+		MappedFile& operator=(const MappedFile& aMappedFile) = delete;
+		~MappedFile();
+		bool Open(const char* aPath);
+		void Close();
+		bool IsOpen() const;
+		const void* GetData() const;
+		size_t GetSize() const;
+
+	private:
+		const void* myData = nullptr;
+		size_t mySize = 0;
+#ifdef _WIN32
+		void* myFile = nullptr;
+		void* myMapping = nullptr;
+#endif
+	};
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+#include "HashMap.hpp"
+#include "MappedFile.hpp"
+
+namespace CommonUtilities
+{
+	// Read-only HashMap served straight from a memory mapped snapshot file, so opening it costs a
+	// file mapping instead of rebuilding the table. Snapshots are written by WriteSnapshot and are
+	// only portable between builds with the same key and value layout, endianness and Hasher.
+	template <class Key, class Value, class Hasher = DefaultHasher<Key>, class Equal = DefaultEqual<Key>>
+	class MappedHashMap
+	{
+		static_assert(std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<Value>, "Snapshots store keys and values as raw bytes");
+		static_assert(alignof(Key) <= 64 && alignof(Value) <= 64, "Snapshot arrays are only aligned to 64 bytes");
+
+	public:
+		MappedHashMap(const Hasher& aHasher = Hasher(), const Equal& aEqual = Equal());
+		MappedHashMap(const MappedHashMap&) = delete;
+		MappedHashMap& operator=(const MappedHashMap&) = delete;
+
+		// Writes the entries of aMap to aPath, placed by aHasher. Seeded or stateful hashers have to be
+		// passed here the same as to the MappedHashMap that reads the file, or lookups will miss.
+		template <class Probing, class Storage>
+		static bool WriteSnapshot(const HashMap<Key, Value, Hasher, Equal, Probing, Storage>& aMap, const char* aPath, const Hasher& aHasher = Hasher());
+
+		// Maps a file written by WriteSnapshot, fails if it is missing, truncated, was written for other
+		// types or has a header that doesn't match the layout its entry count implies
+		bool Open(const char* aPath);
+		void Close();
+		bool IsOpen() const;
+
+		const Value* Get(const Key& aKey) const;
+		bool Contains(const Key& aKey) const;
+		int GetSize() const;
+
+	private:
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t keySize;
+			uint32_t valueSize;
+			uint32_t capacity;
+			uint32_t count;
+			uint64_t statesOffset;
+			uint64_t keysOffset;
+			uint64_t valuesOffset;
+			uint64_t fileSize;
+		};
+
+		static constexpr uint32_t myMagic = 0x4D485543;	// "CUHM"
+		static constexpr uint32_t myVersion = 1;
+		static constexpr uint64_t myArrayAlignment = 64;
+
+		static uint64_t AlignOffset(uint64_t aOffset);
+		static Header MakeHeader(uint32_t aCount);
+
+		MappedFile myFile;
+		const Header* myHeader;
+		const uint8_t* myStates;
+		const Key* myKeys;
+		const Value* myValues;
+		Hasher myHasher;
+		Equal myEqual;
+	};
+
+	template <class Key, class Value, class Hasher, class Equal>
+	MappedHashMap<Key, Value, Hasher, Equal>::MappedHashMap(const Hasher& aHasher, const Equal& aEqual)
+		: myHeader(nullptr), myStates(nullptr), myKeys(nullptr), myValues(nullptr), myHasher(aHasher), myEqual(aEqual)
+	{
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	uint64_t MappedHashMap<Key, Value, Hasher, Equal>::AlignOffset(uint64_t aOffset)
+	{
+		return (aOffset + myArrayAlignment - 1) & ~(myArrayAlignment - 1);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	typename MappedHashMap<Key, Value, Hasher, Equal>::Header MappedHashMap<Key, Value, Hasher, Equal>::MakeHeader(uint32_t aCount)
+	{
+		// Half full at most, so misses find an empty slot after a probe or two
+		uint32_t capacity = 8;
+		while (capacity < aCount * 2)
+		{
+			capacity <<= 1;
+		}
+
+		Header header = {};
+		header.magic = myMagic;
+		header.version = myVersion;
+		header.keySize = sizeof(Key);
+		header.valueSize = sizeof(Value);
+		header.capacity = capacity;
+		header.count = aCount;
+		header.statesOffset = AlignOffset(sizeof(Header));
+		header.keysOffset = AlignOffset(header.statesOffset + capacity);
+		header.valuesOffset = AlignOffset(header.keysOffset + static_cast<uint64_t>(capacity) * sizeof(Key));
+		header.fileSize = header.valuesOffset + static_cast<uint64_t>(capacity) * sizeof(Value);
+		return header;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	template <class Probing, class Storage>
+	bool MappedHashMap<Key, Value, Hasher, Equal>::WriteSnapshot(const HashMap<Key, Value, Hasher, Equal, Probing, Storage>& aMap, const char* aPath, const Hasher& aHasher)
+	{
+		const Header header = MakeHeader(static_cast<uint32_t>(aMap.GetSize()));
+		std::vector<uint8_t> image(header.fileSize, 0);
+		memcpy(image.data(), &header, sizeof(header));
+
+		// Laid out with plain linear probing, whatever policy aMap itself uses
+		const uint32_t mask = header.capacity - 1;
+		for (auto [key, value] : aMap)
+		{
+			uint32_t index = aHasher(key) & mask;
+			while (image[header.statesOffset + index])
+			{
+				index = (index + 1) & mask;
+			}
+			image[header.statesOffset + index] = 1;
+			memcpy(&image[header.keysOffset + index * sizeof(Key)], &key, sizeof(Key));
+			memcpy(&image[header.valuesOffset + index * sizeof(Value)], &value, sizeof(Value));
+		}
+
+		FILE* file = fopen(aPath, "wb");
+		if (!file)
+		{
+			return false;
+		}
+		const bool written = fwrite(image.data(), 1, image.size(), file) == image.size();
+		return (fclose(file) == 0) && written;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool MappedHashMap<Key, Value, Hasher, Equal>::Open(const char* aPath)
+	{
+		Close();
+		if (!myFile.Open(aPath))
+		{
+			return false;
+		}
+
+		// Every field is derived from the count, so anything else in the header means a corrupt file
+		const Header* header = static_cast<const Header*>(myFile.GetData());
+		if (myFile.GetSize() < sizeof(Header) || header->count > (1U << 30))
+		{
+			myFile.Close();
+			return false;
+		}
+		const Header expected = MakeHeader(header->count);
+		if (header->magic != expected.magic || header->version != expected.version ||
+			header->keySize != expected.keySize || header->valueSize != expected.valueSize ||
+			header->capacity != expected.capacity || header->statesOffset != expected.statesOffset ||
+			header->keysOffset != expected.keysOffset || header->valuesOffset != expected.valuesOffset ||
+			header->fileSize != expected.fileSize || header->fileSize > myFile.GetSize())
+		{
+			myFile.Close();
+			return false;
+		}
+
+		const uint8_t* data = static_cast<const uint8_t*>(myFile.GetData());
+		myHeader = header;
+		myStates = data + header->statesOffset;
+		myKeys = reinterpret_cast<const Key*>(data + header->keysOffset);
+		myValues = reinterpret_cast<const Value*>(data + header->valuesOffset);
+		return true;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void MappedHashMap<Key, Value, Hasher, Equal>::Close()
+	{
+		myFile.Close();
+		myHeader = nullptr;
+		myStates = nullptr;
+		myKeys = nullptr;
+		myValues = nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool MappedHashMap<Key, Value, Hasher, Equal>::IsOpen() const
+	{
+		return myHeader != nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	const Value* MappedHashMap<Key, Value, Hasher, Equal>::Get(const Key& aKey) const
+	{
+		if (!myHeader)
+		{
+			return nullptr;
+		}
+
+		// Bounded by the capacity, so a corrupt state array without empty slots can't make this spin forever
+		const uint32_t mask = myHeader->capacity - 1;
+		uint32_t index = myHasher(aKey) & mask;
+		for (uint32_t probe = 0; probe < myHeader->capacity && myStates[index]; probe++)
+		{
+			if (myEqual(myKeys[index], aKey))
+			{
+				return &myValues[index];
+			}
+			index = (index + 1) & mask;
+		}
+		return nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool MappedHashMap<Key, Value, Hasher, Equal>::Contains(const Key& aKey) const
+	{
+		return Get(aKey) != nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	int MappedHashMap<Key, Value, Hasher, Equal>::GetSize() const
+	{
+		return myHeader ? static_cast<int>(myHeader->count) : 0;
+	}
+}
@@ -1,74 +1,155 @@
 #pragma once
-#include <vector>
+#include <new>
+#include <utility>
 #include <cassert>
 
 namespace CommonUtilities
 {
+	// First in, first out queue over a ring buffer. The capacity is a power of two so wrapping is a mask,
+	// it doubles when full and is kept when the queue drains, so a queue that has reached its working size
+	// stops allocating.
 	template <class T>
 	class Queue
 	{
 	public:
 		Queue();
+		Queue(const Queue& aQueue);
+		Queue(Queue&& aQueue) noexcept;
+		Queue& operator=(const Queue& aQueue);
+		Queue& operator=(Queue&& aQueue) noexcept;
+		~Queue();
 
 		int GetSize() const;
+		int GetCapacity() const;
 
 		const T& GetFront() const;
 		T& GetFront();
 
 		void Enqueue(const T& aValue);
+		void Enqueue(T&& aValue);
+		// Constructs the element in place at the back from aArgs
+		template <class... Args>
+		void Emplace(Args&&... aArgs);
+		// Moves the front element out
 		T Dequeue();
+
+		// Makes room for aCount elements without reallocating
+		void Reserve(int aCount);
+		// Destroys all elements but keeps the capacity
+		void Clear();
 	private:
-		std::vector<T> myQueue;
+		static constexpr int myMinCapacity = 8;
+
+		static T* Allocate(int aCapacity);
+		// Moves the elements, in order, into aElements, a new buffer of aCapacity slots, and frees the old one
+		void MoveTo(T* aElements, int aCapacity);
+		// Doubles the capacity, constructing the new back element from aArgs before the old buffer goes away
+		// since aArgs may refer to one of its elements, e.g. q.Enqueue(q.GetFront())
+		template <class... Args>
+		void GrowAndEmplace(Args&&... aArgs);
+
+		T* myElements;
+		int myCapacity;
 		int myFirst;
-		int myLast;
 		int mySize;
 	};
 
 	template <class T>
-	T Queue<T>::Dequeue()
+	Queue<T>::Queue()
 	{
-		assert(mySize > 0 && "Queue size is empty");
-		myFirst++;
-		mySize--;
-		if (!myQueue.size()) return 0;
-		else if (mySize == 0)
-		{
-			auto returnValue = myQueue[myFirst - 1];
-			myFirst = 0;
-			myLast = 0;
-			mySize = 0;
-			myQueue.clear();
-			return returnValue;
-		}
-		else if (myFirst >= myQueue.size()) 
+		myElements = nullptr;
+		myCapacity = 0;
+		myFirst = 0;
+		mySize = 0;
+	}
+
+	template <class T>
+	Queue<T>::Queue(const Queue& aQueue) : Queue()
+	{
+		Reserve(aQueue.mySize);
+		for (int i = 0; i < aQueue.mySize; i++)
 		{
-			myFirst = 0;
-			return myQueue[myQueue.size() - 1];
+			new (&myElements[i]) T(aQueue.myElements[(aQueue.myFirst + i) & (aQueue.myCapacity - 1)]);
+			mySize++;
 		}
-		return myQueue[myFirst - 1];
 	}
 
 	template <class T>
-	void Queue<T>::Enqueue(const T& aValue)
+	Queue<T>::Queue(Queue&& aQueue) noexcept
 	{
-		if (myFirst == 0)
+		myElements = std::exchange(aQueue.myElements, nullptr);
+		myCapacity = std::exchange(aQueue.myCapacity, 0);
+		myFirst = std::exchange(aQueue.myFirst, 0);
+		mySize = std::exchange(aQueue.mySize, 0);
+	}
+
+	template <class T>
+	Queue<T>& Queue<T>::operator=(const Queue& aQueue)
+	{
+		if (this != &aQueue)
 		{
-			myQueue.emplace_back(aValue);
-			myLast++;
+			Queue copy(aQueue);
+			*this = std::move(copy);
 		}
-		else if (myFirst == myLast && mySize > 0)
+		return *this;
+	}
+
+	template <class T>
+	Queue<T>& Queue<T>::operator=(Queue&& aQueue) noexcept
+	{
+		if (this != &aQueue)
 		{
-			auto it = myQueue.begin() + myLast;
-			myQueue.insert(it, aValue);
-			myLast++;
-			myFirst++;
+			Clear();
+			::operator delete(myElements, std::align_val_t(alignof(T)));
+			myElements = std::exchange(aQueue.myElements, nullptr);
+			myCapacity = std::exchange(aQueue.myCapacity, 0);
+			myFirst = std::exchange(aQueue.myFirst, 0);
+			mySize = std::exchange(aQueue.mySize, 0);
 		}
-		else if (myFirst > 0)
+		return *this;
+	}
+
+	template <class T>
+	Queue<T>::~Queue()
+	{
+		Clear();
+		::operator delete(myElements, std::align_val_t(alignof(T)));
+	}
+
+	template <class T>
+	T Queue<T>::Dequeue()
+	{
+		assert(mySize > 0 && "Queue size is empty");
+		T& front = myElements[myFirst];
+		T returnValue = std::move(front);
+		front.~T();
+		myFirst = (myFirst + 1) & (myCapacity - 1);
+		mySize--;
+		return returnValue;
+	}
+
+	template <class T>
+	void Queue<T>::Enqueue(const T& aValue)
+	{
+		Emplace(aValue);
+	}
+
+	template <class T>
+	void Queue<T>::Enqueue(T&& aValue)
+	{
+		Emplace(std::move(aValue));
+	}
+
+	template <class T>
+	template <class... Args>
+	void Queue<T>::Emplace(Args&&... aArgs)
+	{
+		if (mySize == myCapacity)
 		{
-			if (myFirst < myLast) myLast = 1;
-			else myLast++;
-			myQueue[myLast - 1] = aValue;
+			GrowAndEmplace(std::forward<Args>(aArgs)...);
+			return;
 		}
+		new (&myElements[(myFirst + mySize) & (myCapacity - 1)]) T(std::forward<Args>(aArgs)...);
 		mySize++;
 	}
 
@@ -76,14 +157,14 @@ namespace CommonUtilities
 	T& Queue<T>::GetFront()
 	{
 		assert(mySize > 0 && "Queue size is empty");
-		return myQueue[myFirst];
+		return myElements[myFirst];
 	}
 
 	template <class T>
 	const T& Queue<T>::GetFront() const
 	{
 		assert(mySize > 0 && "Queue size is empty");
-		return myQueue[myFirst];
+		return myElements[myFirst];
 	}
 
 	template <class T>
@@ -93,10 +174,74 @@ namespace CommonUtilities
 	}
 
 	template <class T>
-	Queue<T>::Queue()
+	int Queue<T>::GetCapacity() const
+	{
+		return myCapacity;
+	}
+
+	template <class T>
+	void Queue<T>::Reserve(int aCount)
 	{
+		if (aCount <= myCapacity)
+		{
+			return;
+		}
+		int capacity = myCapacity > 0 ? myCapacity : myMinCapacity;
+		while (capacity < aCount)
+		{
+			capacity *= 2;
+		}
+		MoveTo(Allocate(capacity), capacity);
+	}
+
+	template <class T>
+	void Queue<T>::Clear()
+	{
+		for (int i = 0; i < mySize; i++)
+		{
+			myElements[(myFirst + i) & (myCapacity - 1)].~T();
+		}
 		myFirst = 0;
-		myLast = 0;
 		mySize = 0;
 	}
+
+	template <class T>
+	T* Queue<T>::Allocate(int aCapacity)
+	{
+		return static_cast<T*>(::operator new(sizeof(T) * aCapacity, std::align_val_t(alignof(T))));
+	}
+
+	template <class T>
+	template <class... Args>
+	void Queue<T>::GrowAndEmplace(Args&&... aArgs)
+	{
+		const int capacity = myCapacity > 0 ? myCapacity * 2 : myMinCapacity;
+		T* elements = Allocate(capacity);
+		try
+		{
+			new (&elements[mySize]) T(std::forward<Args>(aArgs)...);
+		}
+		catch (...)
+		{
+			::operator delete(elements, std::align_val_t(alignof(T)));
+			throw;
+		}
+		MoveTo(elements, capacity);
+		mySize++;
+	}
+
+	template <class T>
+	void Queue<T>::MoveTo(T* aElements, int aCapacity)
+	{
+		for (int i = 0; i < mySize; i++)
+		{
+			T& element = myElements[(myFirst + i) & (myCapacity - 1)];
+			new (&aElements[i]) T(std::move(element));
+			element.~T();
+		}
+		::operator delete(myElements, std::align_val_t(alignof(T)));
+		myElements = aElements;
+		myCapacity = aCapacity;
+		myFirst = 0;
+	}
 }
@@ -0,0 +1,254 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <array>
+#include <bit>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace CommonUtilities
+{
+	// Hashes usable in constant expressions, for integers, enums and anything convertible to std::string_view
+	template <class Key>
+	struct ConstexprHash
+	{
+		constexpr uint64_t operator()(const Key& aKey) const;
+	};
+
+	// Read-only map over a key list known at compile time. The constructor searches for a collision
+	// free layout with hash and displace: keys are split into small buckets by their hash, and every
+	// bucket gets a seed that scatters its keys into free slots. Get hashes the key once, mixes in its
+	// bucket's seed and compares a single slot. Keys must be unique, and Key and Value default constructible.
+	// Keys convertible to std::string_view, including const char*, are compared by their characters.
+	// Duplicate keys or a failed seed search are a compile error in a constant expression and abort at runtime.
+	template <class Key, class Value, size_t Count, class Hasher = ConstexprHash<Key>>
+	class StaticHashMap
+	{
+	public:
+		constexpr StaticHashMap(const std::pair<Key, Value> (&aEntries)[Count]);
+
+		constexpr const Value* Get(const Key& aKey) const;
+		constexpr bool Contains(const Key& aKey) const;
+		static constexpr int GetSize();
+
+	private:
+		static constexpr size_t myCapacity = std::bit_ceil(Count + Count / 2 + 1);
+		static constexpr size_t myBucketCount = std::bit_ceil((Count + 3) / 4 + 1);
+		static constexpr uint32_t myMaxSeed = 1 << 20;
+
+		static constexpr uint64_t Mix(uint64_t aValue);
+		static constexpr size_t GetBucket(uint64_t aHash);
+		static constexpr size_t GetSlot(uint64_t aHash, uint32_t aSeed);
+		// Same comparison the hasher relies on, by characters for strings rather than by pointer
+		static constexpr bool IsSameKey(const Key& aLeft, const Key& aRight);
+		// Deliberately not constexpr, so reaching it while building a map at compile time fails the build
+		static void Fail(const char* aMessage);
+
+		std::array<Key, myCapacity> myKeys{};
+		std::array<Value, myCapacity> myValues{};
+		std::array<bool, myCapacity> myUsed{};
+		std::array<uint32_t, myBucketCount> mySeeds{};
+	};
+
+	// Lets the entry count be deduced, e.g. MakeStaticHashMap<int, std::string_view>({ { 1, "One" }, { 2, "Two" } })
+	template <class Key, class Value, size_t Count>
+	constexpr StaticHashMap<Key, Value, Count> MakeStaticHashMap(const std::pair<Key, Value> (&aEntries)[Count]);
+
+	template <class Key>
+	constexpr uint64_t ConstexprHash<Key>::operator()(const Key& aKey) const
+	{
+		if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key>)
+		{
+			uint64_t value;
+			if constexpr (std::is_enum_v<Key>)
+			{
+				value = static_cast<uint64_t>(static_cast<std::underlying_type_t<Key>>(aKey));
+			}
+			else
+			{
+				value = static_cast<uint64_t>(aKey);
+			}
+			value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+			return value ^ (value >> 31);
+		}
+		else
+		{
+			static_assert(std::is_convertible_v<const Key&, std::string_view>, "ConstexprHash only handles integers, enums and strings, give StaticHashMap a Hasher for this key");
+
+			// 64 bit FNV-1a
+			const std::string_view string = aKey;
+			uint64_t value = 14695981039346656037ULL;
+			for (char character : string)
+			{
+				value ^= static_cast<uint8_t>(character);
+				value *= 1099511628211ULL;
+			}
+			return value;
+		}
+	}
+
+	template <class Key, class Value, size_t Count, class Hasher>
+	constexpr uint64_t StaticHashMap<Key, Value, Count, Hasher>::Mix(uint64_t aValue)
+	{
+		aValue ^= aValue >> 33;
+		aValue *= 0xff51afd7ed558ccdULL;
+		aValue ^= aValue >> 33;
+		return aValue;
+	}
+
+	template <class Key, class Value, size_t Count, class Hasher>
+	constexpr size_t StaticHashMap<Key, Value, Count, Hasher>::GetBucket(uint64_t aHash)
+	{
+		return static_cast<size_t>(aHash >> 32) & (myBucketCount - 1);
+	}
+
+	template <class Key, class Value, size_t Count, class Hasher>
+	constexpr size_t StaticHashMap<Key, Value, Count, Hasher>::GetSlot(uint64_t aHash, uint32_t aSeed)
+	{
+		return static_cast<size_t>(Mix(aHash ^ (aSeed * 0x9e3779b97f4a7c15ULL))) & (myCapacity - 1);
+	}
+
+	template <class Key, class Value, size_t Count, class Hasher>
+	constexpr bool StaticHashMap<Key, Value, Count, Hasher>::IsSameKey(const Key& aLeft, const Key& aRight)
+	{
+		if constexpr (std::is_convertible_v<const Key&, std::string_view>)
+		{
+			return std::string_view(aLeft) == std::string_view(aRight);
+		}
+		else
+		{
+			return aLeft == aRight;
+		}
+	}
+
+	template <class Key, class Value, size_t Count, class Hasher>
+	void StaticHashMap<Key, Value, Count, Hasher>::Fail(const char* aMessage)
+	{
+		fprintf(stderr, "%s\n", aMessage);
+		abort();
+	}
+
+	template <class Key, class Value, size_t Count, class Hasher>
+	constexpr StaticHashMap<Key, Value, Count, Hasher>::StaticHashMap(const std::pair<Key, Value> (&aEntries)[Count])
+	{
+		std::array<uint64_t, Count> hashes{};
+		std::array<size_t, myBucketCount> bucketSizes{};
+		for (size_t i = 0; i < Count; i++)
+		{
+			for (size_t j = 0; j < i; j++)
+			{
+				if (IsSameKey(aEntries[j].first, aEntries[i].first))
+				{
+					Fail("StaticHashMap keys must be unique.");
+				}
+			}
+			hashes[i] = Hasher()(aEntries[i].first);
+			bucketSizes[GetBucket(hashes[i])]++;
+		}
+
+		// Place the largest buckets first, while most slots are still free
+		std::array<size_t, myBucketCount> order{};
+		for (size_t i = 0; i < myBucketCount; i++)
+		{
+			order[i] = i;
+		}
+		for (size_t i = 1; i < myBucketCount; i++)
+		{
+			for (size_t j = i; j > 0 && bucketSizes[order[j - 1]] < bucketSizes[order[j]]; j--)
+			{
+				std::swap(order[j - 1], order[j]);
+			}
+		}
+
+		// Key indices grouped by bucket, so each seed attempt only looks at the bucket's own keys
+		std::array<size_t, myBucketCount + 1> bucketStarts{};
+		for (size_t i = 0; i < myBucketCount; i++)
+		{
+			bucketStarts[i + 1] = bucketStarts[i] + bucketSizes[i];
+		}
+		std::array<size_t, Count> members{};
+		std::array<size_t, myBucketCount> filled{};
+		for (size_t i = 0; i < Count; i++)
+		{
+			const size_t bucket = GetBucket(hashes[i]);
+			members[bucketStarts[bucket] + filled[bucket]++] = i;
+		}
+
+		std::array<size_t, Count> slots{};
+		for (size_t bucket : order)
+		{
+			const size_t first = bucketStarts[bucket];
+			const size_t size = bucketSizes[bucket];
+			if (!size)
+			{
+				break;
+			}
+
+			uint32_t seed = 0;
+			for (; seed < myMaxSeed; seed++)
+			{
+				bool fits = true;
+				for (size_t i = 0; i < size && fits; i++)
+				{
+					slots[i] = GetSlot(hashes[members[first + i]], seed);
+					fits = !myUsed[slots[i]];
+					for (size_t j = 0; j < i && fits; j++)
+					{
+						fits = slots[j] != slots[i];
+					}
+				}
+				if (fits)
+				{
+					break;
+				}
+			}
+			if (seed == myMaxSeed)
+			{
+				Fail("StaticHashMap found no collision free seed, give it a better Hasher.");
+			}
+
+			mySeeds[bucket] = seed;
+			for (size_t i = 0; i < size; i++)
+			{
+				const size_t entry = members[first + i];
+				myKeys[slots[i]] = aEntries[entry].first;
+				myValues[slots[i]] = aEntries[entry].second;
+				myUsed[slots[i]] = true;
+			}
+		}
+	}
+
+	template <class Key, class Value, size_t Count, class Hasher>
+	constexpr const Value* StaticHashMap<Key, Value, Count, Hasher>::Get(const Key& aKey) const
+	{
+		const uint64_t hash = Hasher()(aKey);
+		const size_t slot = GetSlot(hash, mySeeds[GetBucket(hash)]);
+		if (myUsed[slot] && IsSameKey(myKeys[slot], aKey))
+		{
+			return &myValues[slot];
+		}
+		return nullptr;
+	}
+
+	template <class Key, class Value, size_t Count, class Hasher>
+	constexpr bool StaticHashMap<Key, Value, Count, Hasher>::Contains(const Key& aKey) const
+	{
+		return Get(aKey) != nullptr;
+	}
+
+	template <class Key, class Value, size_t Count, class Hasher>
+	constexpr int StaticHashMap<Key, Value, Count, Hasher>::GetSize()
+	{
+		return static_cast<int>(Count);
+	}
+
+	template <class Key, class Value, size_t Count>
+	constexpr StaticHashMap<Key, Value, Count> MakeStaticHashMap(const std::pair<Key, Value> (&aEntries)[Count])
+	{
+		return StaticHashMap<Key, Value, Count>(aEntries);
+	}
+}
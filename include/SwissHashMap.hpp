@@ -0,0 +1,360 @@
+#pragma once
+#include <stdint.h>
+#include <bit>
+#include <new>
+#include <functional>
+#include <utility>
+#include "Hashers.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define COMMONUTILITIES_SSE2
+#endif
+
+namespace CommonUtilities
+{
+	// Open addressing map in the style of Swiss tables. Every slot has a control byte that is
+	// either a special marker or the low 7 bits of the key's hash, and lookups compare 16 control
+	// bytes at a time, so most probes are answered without touching the keys at all.
+	template <class Key, class Value, class Hasher = DefaultHasher<Key>, class Equal = DefaultEqual<Key>>
+	class SwissHashMap
+	{
+	public:
+		SwissHashMap(int aCapacity = 0, const Hasher& aHasher = Hasher(), const Equal& aEqual = Equal());
+		SwissHashMap(const SwissHashMap&) = delete;
+		SwissHashMap& operator=(const SwissHashMap&) = delete;
+		~SwissHashMap();
+		bool Insert(const Key& aKey, const Value& aValue);
+		bool Remove(const Key& aKey);
+		const Value* Get(const Key& aKey) const;
+		Value* Get(const Key& aKey);
+
+		// Makes room for aCount entries without rehashing
+		void Reserve(int aCount);
+
+		int GetSize() const;
+		int GetCapacity() const;
+
+	private:
+		struct Slot
+		{
+			Key key;
+			Value value;
+		};
+
+		// Control bytes of full slots hold the 7 bit hash fragment, so the sign bit marks special ones
+		static constexpr int8_t myEmpty = -128;
+		static constexpr int8_t myDeleted = -2;
+		static constexpr uint32_t myGroupWidth = 16;
+		static constexpr uint32_t myInvalidIndex = UINT32_MAX;
+
+		// Sixteen control bytes matched in parallel, each query returns one bit per matching slot
+		class Group
+		{
+		public:
+			explicit Group(const int8_t* aControl);
+			uint32_t Match(int8_t aFragment) const;
+			uint32_t MatchEmpty() const;
+			uint32_t MatchEmptyOrDeleted() const;
+
+		private:
+#ifdef COMMONUTILITIES_SSE2
+			__m128i myControl;
+#else
+			const int8_t* myControl;
+#endif
+		};
+
+		static int8_t GetFragment(uint32_t aHash);
+		uint32_t Find(const Key& aKey, uint32_t aHash) const;
+		uint32_t FindFree(uint32_t aHash) const;
+		void SetControl(uint32_t aIndex, int8_t aControl);
+		void Resize(uint32_t aCapacity);
+		void Release();
+
+		int8_t* myControl;
+		Slot* mySlots;
+		uint32_t myCapacity;
+		uint32_t mySize;
+		uint32_t myGrowthLeft;
+		Hasher myHasher;
+		Equal myEqual;
+	};
+
+	template <class Key, class Value, class Hasher, class Equal>
+	SwissHashMap<Key, Value, Hasher, Equal>::Group::Group(const int8_t* aControl)
+	{
+#ifdef COMMONUTILITIES_SSE2
+		myControl = _mm_load_si128(reinterpret_cast<const __m128i*>(aControl));
+#else
+		myControl = aControl;
+#endif
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	uint32_t SwissHashMap<Key, Value, Hasher, Equal>::Group::Match(int8_t aFragment) const
+	{
+#ifdef COMMONUTILITIES_SSE2
+		return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(aFragment), myControl)));
+#else
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < myGroupWidth; i++)
+		{
+			mask |= static_cast<uint32_t>(myControl[i] == aFragment) << i;
+		}
+		return mask;
+#endif
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	uint32_t SwissHashMap<Key, Value, Hasher, Equal>::Group::MatchEmpty() const
+	{
+		return Match(myEmpty);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	uint32_t SwissHashMap<Key, Value, Hasher, Equal>::Group::MatchEmptyOrDeleted() const
+	{
+#ifdef COMMONUTILITIES_SSE2
+		return static_cast<uint32_t>(_mm_movemask_epi8(myControl));
+#else
+		uint32_t mask = 0;
+		for (uint32_t i = 0; i < myGroupWidth; i++)
+		{
+			mask |= static_cast<uint32_t>(myControl[i] < 0) << i;
+		}
+		return mask;
+#endif
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	int8_t SwissHashMap<Key, Value, Hasher, Equal>::GetFragment(uint32_t aHash)
+	{
+		return static_cast<int8_t>(aHash & 0x7F);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	uint32_t SwissHashMap<Key, Value, Hasher, Equal>::Find(const Key& aKey, uint32_t aHash) const
+	{
+		if (!mySize)
+		{
+			return myInvalidIndex;
+		}
+
+		// Triangular steps over a power of two number of groups visit every group exactly once
+		const uint32_t groupMask = myCapacity / myGroupWidth - 1;
+		const int8_t fragment = GetFragment(aHash);
+		uint32_t group = (aHash >> 7) & groupMask;
+		for (uint32_t step = 1; step <= groupMask + 1; step++)
+		{
+			const uint32_t first = group * myGroupWidth;
+			const Group control(myControl + first);
+			for (uint32_t match = control.Match(fragment); match; match &= match - 1)
+			{
+				const uint32_t index = first + static_cast<uint32_t>(std::countr_zero(match));
+				if (myEqual(mySlots[index].key, aKey))
+				{
+					return index;
+				}
+			}
+			if (control.MatchEmpty())
+			{
+				return myInvalidIndex;
+			}
+			group = (group + step) & groupMask;
+		}
+		return myInvalidIndex;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	uint32_t SwissHashMap<Key, Value, Hasher, Equal>::FindFree(uint32_t aHash) const
+	{
+		const uint32_t groupMask = myCapacity / myGroupWidth - 1;
+		uint32_t group = (aHash >> 7) & groupMask;
+		for (uint32_t step = 1; step <= groupMask + 1; step++)
+		{
+			const uint32_t first = group * myGroupWidth;
+			const uint32_t match = Group(myControl + first).MatchEmptyOrDeleted();
+			if (match)
+			{
+				return first + static_cast<uint32_t>(std::countr_zero(match));
+			}
+			group = (group + step) & groupMask;
+		}
+		return myInvalidIndex;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void SwissHashMap<Key, Value, Hasher, Equal>::SetControl(uint32_t aIndex, int8_t aControl)
+	{
+		myControl[aIndex] = aControl;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void SwissHashMap<Key, Value, Hasher, Equal>::Resize(uint32_t aCapacity)
+	{
+		int8_t* oldControl = myControl;
+		Slot* oldSlots = mySlots;
+		const uint32_t oldCapacity = myCapacity;
+
+		myCapacity = aCapacity;
+		myControl = static_cast<int8_t*>(::operator new(myCapacity, std::align_val_t(myGroupWidth)));
+		mySlots = static_cast<Slot*>(::operator new(sizeof(Slot) * myCapacity, std::align_val_t(alignof(Slot))));
+		for (uint32_t i = 0; i < myCapacity; i++)
+		{
+			myControl[i] = myEmpty;
+		}
+		myGrowthLeft = myCapacity - myCapacity / 8 - mySize;
+
+		for (uint32_t i = 0; i < oldCapacity; i++)
+		{
+			if (oldControl[i] >= 0)
+			{
+				const uint32_t hash = myHasher(oldSlots[i].key);
+				const uint32_t index = FindFree(hash);
+				new (&mySlots[index]) Slot{ std::move(oldSlots[i].key), std::move(oldSlots[i].value) };
+				SetControl(index, GetFragment(hash));
+				oldSlots[i].~Slot();
+			}
+		}
+
+		if (oldControl)
+		{
+			::operator delete(oldControl, std::align_val_t(myGroupWidth));
+			::operator delete(oldSlots, std::align_val_t(alignof(Slot)));
+		}
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void SwissHashMap<Key, Value, Hasher, Equal>::Release()
+	{
+		if (!myControl)
+		{
+			return;
+		}
+		for (uint32_t i = 0; i < myCapacity; i++)
+		{
+			if (myControl[i] >= 0)
+			{
+				mySlots[i].~Slot();
+			}
+		}
+		::operator delete(myControl, std::align_val_t(myGroupWidth));
+		::operator delete(mySlots, std::align_val_t(alignof(Slot)));
+		myControl = nullptr;
+		mySlots = nullptr;
+		myCapacity = 0;
+		mySize = 0;
+		myGrowthLeft = 0;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	Value* SwissHashMap<Key, Value, Hasher, Equal>::Get(const Key& aKey)
+	{
+		return const_cast<Value*>(static_cast<const SwissHashMap<Key, Value, Hasher, Equal>*>(this)->Get(aKey));
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	const Value* SwissHashMap<Key, Value, Hasher, Equal>::Get(const Key& aKey) const
+	{
+		const uint32_t index = Find(aKey, myHasher(aKey));
+		return (index != myInvalidIndex) ? &mySlots[index].value : nullptr;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool SwissHashMap<Key, Value, Hasher, Equal>::Remove(const Key& aKey)
+	{
+		const uint32_t index = Find(aKey, myHasher(aKey));
+		if (index == myInvalidIndex)
+		{
+			return false;
+		}
+
+		mySlots[index].~Slot();
+		mySize--;
+
+		// A group that still has an empty slot never made a probe move on, so no chain runs through it
+		const uint32_t first = index & ~(myGroupWidth - 1);
+		if (Group(myControl + first).MatchEmpty())
+		{
+			SetControl(index, myEmpty);
+			myGrowthLeft++;
+		}
+		else
+		{
+			SetControl(index, myDeleted);
+		}
+		return true;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	bool SwissHashMap<Key, Value, Hasher, Equal>::Insert(const Key& aKey, const Value& aValue)
+	{
+		const uint32_t hash = myHasher(aKey);
+		const uint32_t found = Find(aKey, hash);
+		if (found != myInvalidIndex)
+		{
+			mySlots[found].value = aValue;
+			return true;
+		}
+
+		uint32_t index = myCapacity ? FindFree(hash) : myInvalidIndex;
+		if (index == myInvalidIndex || (!myGrowthLeft && myControl[index] != myDeleted))
+		{
+			// Rehashing at the same size is enough to flush out tombstones when the map is sparse
+			const bool isSparse = mySize < (myCapacity - myCapacity / 8) / 2;
+			Resize(!myCapacity ? myGroupWidth : isSparse ? myCapacity : myCapacity * 2);
+			index = FindFree(hash);
+		}
+
+		if (myControl[index] == myEmpty)
+		{
+			myGrowthLeft--;
+		}
+		new (&mySlots[index]) Slot{ aKey, aValue };
+		SetControl(index, GetFragment(hash));
+		mySize++;
+		return true;
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	void SwissHashMap<Key, Value, Hasher, Equal>::Reserve(int aCount)
+	{
+		uint32_t capacity = myGroupWidth;
+		while (capacity - capacity / 8 < static_cast<uint32_t>(aCount))
+		{
+			capacity <<= 1;
+		}
+		if (capacity > myCapacity)
+		{
+			Resize(capacity);
+		}
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	int SwissHashMap<Key, Value, Hasher, Equal>::GetSize() const
+	{
+		return static_cast<int>(mySize);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	int SwissHashMap<Key, Value, Hasher, Equal>::GetCapacity() const
+	{
+		return static_cast<int>(myCapacity);
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	SwissHashMap<Key, Value, Hasher, Equal>::~SwissHashMap()
+	{
+		Release();
+	}
+
+	template <class Key, class Value, class Hasher, class Equal>
+	SwissHashMap<Key, Value, Hasher, Equal>::SwissHashMap(int aCapacity, const Hasher& aHasher, const Equal& aEqual) : myControl(nullptr), mySlots(nullptr), myCapacity(0), mySize(0), myGrowthLeft(0), myHasher(aHasher), myEqual(aEqual)
+	{
+		if (aCapacity > 0)
+		{
+			Reserve(aCapacity);
+		}
+	}
+}
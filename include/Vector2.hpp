@@ -191,4 +191,7 @@ namespace CommonUtilities
 
 	//Equivalent to setting aVector to (aVector / aScalar)
 	template <class T> void operator/=(Vector2<T>& aVector, const T& aScalar) { aVector = { aVector.x / aScalar, aVector.y / aScalar }; }
+
+	//Returns true if every component of aVector0 equals the matching component of aVector1
+	template <class T> bool operator==(const Vector2<T>& aVector0, const Vector2<T>& aVector1) { return (aVector0.x == aVector1.x) && (aVector0.y == aVector1.y); }
 }
\ No newline at end of file
@@ -145,5 +145,6 @@ namespace CommonUtilities
 	//Equivalent to setting aVector to (aVector / aScalar)
 	template <class T> void operator/=(Vector3<T>& aVector, const T& aScalar) { aVector = { aVector.x / aScalar, aVector.y / aScalar, aVector.z / aScalar }; }
 
-	template <class T> bool operator==(Vector3<T>& aVector, Vector3<T>& aVector2) { return (aVector.x == aVector2.x) && (aVector.y == aVector2.y) && (aVector.z == aVector2.z); };
+	//Returns true if every component of aVector0 equals the matching component of aVector1
+	template <class T> bool operator==(const Vector3<T>& aVector0, const Vector3<T>& aVector1) { return (aVector0.x == aVector1.x) && (aVector0.y == aVector1.y) && (aVector0.z == aVector1.z); }
 }
\ No newline at end of file
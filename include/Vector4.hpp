@@ -136,4 +136,7 @@ namespace CommonUtilities
 
 	//Equivalent to setting aVector to (aVector / aScalar)
 	template <class T> void operator/=(Vector4<T>& aVector, const T& aScalar) { aVector = { aVector.x / aScalar, aVector.y / aScalar, aVector.z / aScalar, aVector.w / aScalar }; }
+
+	//Returns true if every component of aVector0 equals the matching component of aVector1
+	template <class T> bool operator==(const Vector4<T>& aVector0, const Vector4<T>& aVector1) { return (aVector0.x == aVector1.x) && (aVector0.y == aVector1.y) && (aVector0.z == aVector1.z) && (aVector0.w == aVector1.w); }
 }
\ No newline at end of file
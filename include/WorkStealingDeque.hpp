@@ -0,0 +1,206 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+namespace CommonUtilities
+{
+	// Chase-Lev work-stealing deque, with the memory orderings from Le et al. for weak memory models. The
+	// owning thread pushes and pops at the bottom like a stack, so it works on its newest, cache-warm tasks,
+	// while other threads steal the oldest tasks from the top. The owner only touches shared state when the
+	// deque is down to its last element. The buffer doubles when full; replaced buffers are kept until the
+	// deque is destroyed since a thief may still be reading from one. Elements are read by thieves that may
+	// lose the race for them, so T has to be trivially copyable, e.g. a task pointer or index.
+	template <class T>
+	class WorkStealingDeque
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque elements are copied racily and must be trivially copyable");
+
+	public:
+		// aCapacity is rounded up to a power of two
+		WorkStealingDeque(int aCapacity = 64);
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+		~WorkStealingDeque();
+
+		// Owner thread only
+		void Push(const T& aValue);
+		// Owner thread only, takes the newest element, returns false if the deque is empty
+		bool Pop(T& outValue);
+		// Any thread, takes the oldest element. Returns false if the deque is empty or another thread
+		// took the element first, so a thief should move on to another deque rather than spin here.
+		bool Steal(T& outValue);
+
+		// Only a snapshot while other threads are running
+		int GetSize() const;
+		bool IsEmpty() const;
+		int GetCapacity() const;
+
+	private:
+		struct Buffer
+		{
+			Buffer(int64_t aCapacity);
+			~Buffer();
+
+			T Get(int64_t aIndex) const;
+			void Put(int64_t aIndex, const T& aValue);
+			// Returns a buffer twice the size holding the elements in [aTop, aBottom)
+			Buffer* Grow(int64_t aTop, int64_t aBottom) const;
+
+			int64_t capacity;
+			std::atomic<T>* elements;
+		};
+
+		alignas(64) std::atomic<int64_t> myTop;		// Advanced by thieves and by the owner taking the last element
+		alignas(64) std::atomic<int64_t> myBottom;	// Written by the owner only
+		std::atomic<Buffer*> myBuffer;
+		std::vector<Buffer*> myRetiredBuffers;
+	};
+
+	template <class T>
+	WorkStealingDeque<T>::Buffer::Buffer(int64_t aCapacity) : capacity(aCapacity), elements(new std::atomic<T>[aCapacity])
+	{
+	}
+
+	template <class T>
+	WorkStealingDeque<T>::Buffer::~Buffer()
+	{
+		delete[] elements;
+	}
+
+	template <class T>
+	T WorkStealingDeque<T>::Buffer::Get(int64_t aIndex) const
+	{
+		return elements[aIndex & (capacity - 1)].load(std::memory_order_relaxed);
+	}
+
+	template <class T>
+	void WorkStealingDeque<T>::Buffer::Put(int64_t aIndex, const T& aValue)
+	{
+		elements[aIndex & (capacity - 1)].store(aValue, std::memory_order_relaxed);
+	}
+
+	template <class T>
+	typename WorkStealingDeque<T>::Buffer* WorkStealingDeque<T>::Buffer::Grow(int64_t aTop, int64_t aBottom) const
+	{
+		Buffer* buffer = new Buffer(capacity * 2);
+		for (int64_t i = aTop; i < aBottom; i++)
+		{
+			buffer->Put(i, Get(i));
+		}
+		return buffer;
+	}
+
+	template <class T>
+	WorkStealingDeque<T>::WorkStealingDeque(int aCapacity) : myTop(0), myBottom(0)
+	{
+		int64_t capacity = 2;
+		while (capacity < aCapacity)
+		{
+			capacity *= 2;
+		}
+		myBuffer.store(new Buffer(capacity), std::memory_order_relaxed);
+	}
+
+	template <class T>
+	WorkStealingDeque<T>::~WorkStealingDeque()
+	{
+		delete myBuffer.load(std::memory_order_relaxed);
+		for (Buffer* buffer : myRetiredBuffers)
+		{
+			delete buffer;
+		}
+	}
+
+	template <class T>
+	void WorkStealingDeque<T>::Push(const T& aValue)
+	{
+		const int64_t bottom = myBottom.load(std::memory_order_relaxed);
+		const int64_t top = myTop.load(std::memory_order_acquire);
+		Buffer* buffer = myBuffer.load(std::memory_order_relaxed);
+		if (bottom - top > buffer->capacity - 1)
+		{
+			myRetiredBuffers.push_back(buffer);
+			buffer = buffer->Grow(top, bottom);
+			myBuffer.store(buffer, std::memory_order_release);
+		}
+
+		buffer->Put(bottom, aValue);
+		std::atomic_thread_fence(std::memory_order_release);
+		myBottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	template <class T>
+	bool WorkStealingDeque<T>::Pop(T& outValue)
+	{
+		// Claim the bottom element first, then check whether a thief got there too
+		const int64_t bottom = myBottom.load(std::memory_order_relaxed) - 1;
+		Buffer* buffer = myBuffer.load(std::memory_order_relaxed);
+		myBottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = myTop.load(std::memory_order_relaxed);
+
+		if (top > bottom)
+		{
+			myBottom.store(bottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		const T value = buffer->Get(bottom);
+		if (top == bottom)
+		{
+			// Last element, race the thieves for it on myTop
+			const bool won = myTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			myBottom.store(bottom + 1, std::memory_order_relaxed);
+			if (!won)
+			{
+				return false;
+			}
+		}
+		outValue = value;
+		return true;
+	}
+
+	template <class T>
+	bool WorkStealingDeque<T>::Steal(T& outValue)
+	{
+		int64_t top = myTop.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const int64_t bottom = myBottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+		{
+			return false;
+		}
+
+		// Read before claiming, the buffer slot may be overwritten by a push as soon as myTop moves on
+		Buffer* buffer = myBuffer.load(std::memory_order_acquire);
+		const T value = buffer->Get(top);
+		if (!myTop.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			return false;
+		}
+		outValue = value;
+		return true;
+	}
+
+	template <class T>
+	int WorkStealingDeque<T>::GetSize() const
+	{
+		const int64_t bottom = myBottom.load(std::memory_order_relaxed);
+		const int64_t top = myTop.load(std::memory_order_relaxed);
+		return bottom > top ? static_cast<int>(bottom - top) : 0;
+	}
+
+	template <class T>
+	bool WorkStealingDeque<T>::IsEmpty() const
+	{
+		return GetSize() == 0;
+	}
+
+	template <class T>
+	int WorkStealingDeque<T>::GetCapacity() const
+	{
+		return static_cast<int>(myBuffer.load(std::memory_order_relaxed)->capacity);
+	}
+}
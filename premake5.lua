@@ -28,6 +28,10 @@ project "CommonUtilities"
 		"**.cpp"
 	}
 
+	removefiles {
+		"tests/**"
+	}
+
 	includedirs {
 		".",
 		"./include/"
@@ -46,4 +50,52 @@ project "CommonUtilities"
 	filter "system:windows"
 		kind "ConsoleApp"	
 		systemversion "latest"
-		
\ No newline at end of file
+		
+
+-- Standalone console programs in tests/, one per file, each built against the headers alone
+function testproject(name)
+	project(name)
+		location "."
+		kind "ConsoleApp"
+
+		language "C++"
+		cppdialect "C++20"
+
+		targetdir ("./bin/%{prj.name}/" .. outputdir)
+		targetname("%{prj.name}-%{cfg.buildcfg}")
+		objdir ("./bin-int/%{prj.name}/" .. outputdir)
+
+		files {
+			"tests/" .. name .. ".cpp"
+		}
+
+		includedirs {
+			"./include/"
+		}
+
+		filter "configurations:Debug"
+			defines "_DEBUG"
+			runtime "Debug"
+			symbols "on"
+
+		filter "configurations:Release"
+			defines "_RELEASE"
+			runtime "Release"
+			optimize "on"
+
+		filter "system:windows"
+			systemversion "latest"
+
+		filter "system:linux"
+			links { "pthread" }
+
+		filter {}
+end
+
+testproject "WorkStealingDequeStress"
+testproject "QueueTest"
+testproject "QueueBenchmark"
+testproject "HashMapTest"
+testproject "IndexedHeapBenchmark"
+testproject "ConcurrentHashMapBenchmark"
+testproject "WorkStealingDequeBenchmark"
@@ -0,0 +1,137 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "../include/ConcurrentHashMap.hpp"
+
+// Measures how ConcurrentHashMap lookups scale with the number of threads, against a single HashMap
+// behind one shared lock. Every thread looks up its own random sequence of keys, a fraction of which
+// are missing, and the found counts are checked so a wrong result is reported instead of timed.
+namespace
+{
+	constexpr int myRepeats = 3;
+	constexpr uint32_t myKeyCount = 1 << 20;
+	constexpr int myLookupsPerThread = 2000000;
+
+	// One HashMap with a single reader/writer lock around it
+	class LockedHashMap
+	{
+	public:
+		LockedHashMap(int aCapacity) : myMap(aCapacity, CommonUtilities::eHashGrowth::Rehash)
+		{
+		}
+
+		void Insert(uint32_t aKey, uint32_t aValue)
+		{
+			std::unique_lock lock(myMutex);
+			myMap.Insert(aKey, aValue);
+		}
+
+		bool Get(uint32_t aKey, uint32_t& outValue) const
+		{
+			std::shared_lock lock(myMutex);
+			const uint32_t* value = myMap.Get(aKey);
+			if (!value)
+			{
+				return false;
+			}
+			outValue = *value;
+			return true;
+		}
+
+	private:
+		mutable std::shared_mutex myMutex;
+		CommonUtilities::HashMap<uint32_t, uint32_t> myMap;
+	};
+
+	// Even keys are in the map, so about half of the lookups miss
+	template <class Map>
+	uint64_t Lookup(const Map& aMap, int aThread)
+	{
+		std::mt19937 random(static_cast<uint32_t>(aThread) + 1);
+		uint64_t found = 0;
+		uint32_t value;
+		for (int i = 0; i < myLookupsPerThread; i++)
+		{
+			if (aMap.Get(random() % (myKeyCount * 2), value))
+			{
+				found++;
+			}
+		}
+		return found;
+	}
+
+	template <class Map>
+	double RunThreads(const Map& aMap, int aThreadCount, uint64_t aExpected)
+	{
+		std::vector<std::thread> threads;
+		std::vector<uint64_t> found(aThreadCount, 0);
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < aThreadCount; i++)
+		{
+			threads.emplace_back([&aMap, &found, i] { found[i] = Lookup(aMap, i); });
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		uint64_t total = 0;
+		for (uint64_t count : found)
+		{
+			total += count;
+		}
+		return (total == aExpected) ? seconds : -1.0;
+	}
+
+	template <class Map>
+	void Measure(const char* aName, const Map& aMap, int aThreadCount, uint64_t aExpected)
+	{
+		double best = 0.0;
+		for (int repeat = 0; repeat < myRepeats; repeat++)
+		{
+			const double seconds = RunThreads(aMap, aThreadCount, aExpected);
+			if (seconds < 0.0)
+			{
+				printf("  %-20s returned the wrong values\n", aName);
+				return;
+			}
+			best = (repeat == 0 || seconds < best) ? seconds : best;
+		}
+		const double lookups = static_cast<double>(aThreadCount) * myLookupsPerThread;
+		printf("  %-20s %8.1f M lookups/s\n", aName, lookups / best / 1000000.0);
+	}
+}
+
+int main()
+{
+	CommonUtilities::ConcurrentHashMap<uint32_t, uint32_t> sharded(myKeyCount, 64);
+	LockedHashMap locked(myKeyCount);
+	for (uint32_t key = 0; key < myKeyCount * 2; key += 2)
+	{
+		sharded.Insert(key, key);
+		locked.Insert(key, key);
+	}
+
+	const int coreCount = static_cast<int>(std::thread::hardware_concurrency());
+	const int maxThreadCount = (coreCount > 1) ? coreCount : 1;
+	for (int threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2)
+	{
+		// The expected count comes from a single threaded pass over the same key sequences
+		uint64_t expected = 0;
+		for (int i = 0; i < threadCount; i++)
+		{
+			expected += Lookup(locked, i);
+		}
+
+		printf("%d threads\n", threadCount);
+		Measure("ConcurrentHashMap", sharded, threadCount, expected);
+		Measure("Locked HashMap", locked, threadCount, expected);
+	}
+	return 0;
+}
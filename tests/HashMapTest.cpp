@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <string>
+#include "../include/HashMap.hpp"
+
+// Functional tests for HashMap inserts and removals whose arguments refer to entries already in the map.
+// Growing, compacting and migrating all move entries, so these read freed memory unless the new entry
+// is built first. Values are heap allocated strings, so such reads are caught by sanitizers and debug heaps.
+namespace
+{
+	int myFailureCount = 0;
+
+	void Check(bool aCondition, const char* aMessage)
+	{
+		if (!aCondition)
+		{
+			printf("FAILED: %s\n", aMessage);
+			myFailureCount++;
+		}
+	}
+
+	std::string MakeKey(int aIndex)
+	{
+		return "key number " + std::to_string(aIndex) + " long enough to allocate";
+	}
+
+	std::string MakeValue(int aIndex)
+	{
+		return "value number " + std::to_string(aIndex) + " long enough to allocate";
+	}
+
+	template <class Map>
+	void TestSelfReferencingInsert(int aCapacity, CommonUtilities::eHashGrowth aGrowth)
+	{
+		// Every insert copies the value of an earlier entry, across many grows and migrations
+		Map map(aCapacity, aGrowth);
+		map.Insert(MakeKey(0), MakeValue(0));
+		for (int i = 1; i < 2000; i++)
+		{
+			Check(map.Insert(MakeKey(i), *map.Get(MakeKey(i / 2))), "Insert of a value from the map");
+			Check(*map.Get(MakeKey(i)) == MakeValue(0), "Insert copies the referenced value");
+		}
+
+		Map emplaced(aCapacity, aGrowth);
+		emplaced.Insert(MakeKey(0), MakeValue(0));
+		for (int i = 1; i < 2000; i++)
+		{
+			emplaced.Emplace(MakeKey(i), *emplaced.Get(MakeKey(i - 1)));
+			emplaced.TryEmplace(MakeKey(i + 100000), *emplaced.Get(MakeKey(i)), 0, 5);
+		}
+		Check(emplaced.GetSize() == 3999, "Emplace and TryEmplace of values from the map add entries");
+		Check(*emplaced.Get(MakeKey(1999)) == MakeValue(0), "Emplace copies the referenced value");
+		Check(*emplaced.Get(MakeKey(101999)) == "value", "TryEmplace constructs from the referenced value");
+
+		// Moving a value out of its own entry leaves that entry valid but unspecified
+		Map assigned(aCapacity, aGrowth);
+		assigned.Insert(MakeKey(0), MakeValue(0));
+		for (int i = 1; i < 2000; i++)
+		{
+			assigned.InsertOrAssign(MakeKey(i), std::move(*assigned.Get(MakeKey(i - 1))));
+		}
+		Check(*assigned.Get(MakeKey(1999)) == MakeValue(0), "InsertOrAssign moves the referenced value");
+	}
+
+	template <class Map>
+	void TestSelfReferencingKey(int aCapacity, CommonUtilities::eHashGrowth aGrowth)
+	{
+		// Each value names the key of the next entry, so the key argument refers into the map
+		Map map(aCapacity, aGrowth);
+		map.Insert(MakeKey(0), MakeKey(1));
+		for (int i = 1; i < 2000; i++)
+		{
+			const std::string& key = *map.Get(MakeKey(i - 1));
+			Check(map.Emplace(key, MakeKey(i + 1)).second, "Emplace with a key from the map adds an entry");
+		}
+		for (int i = 0; i < 2000; i++)
+		{
+			const std::string* value = map.Get(MakeKey(i));
+			Check(value != nullptr && *value == MakeKey(i + 1), "Emplace with a key from the map stores it");
+		}
+
+		// Removing by a key that lives in the map, while old entries are still migrating
+		while (map.GetSize() > 0)
+		{
+			const std::string& key = map.begin().GetKey();
+			const int size = map.GetSize();
+			Check(map.Remove(key), "Remove with a key from the map");
+			Check(map.GetSize() == size - 1, "Remove with a key from the map removes one entry");
+		}
+	}
+
+	template <class Probing, class Storage>
+	void TestPolicies()
+	{
+		using Map = CommonUtilities::HashMap<std::string, std::string, CommonUtilities::DefaultHasher<std::string>, CommonUtilities::DefaultEqual<std::string>, Probing, Storage>;
+		// A fixed map never moves entries to grow, but Robin Hood probing still displaces them on insert
+		TestSelfReferencingInsert<Map>(4096, CommonUtilities::eHashGrowth::Fixed);
+		TestSelfReferencingInsert<Map>(8, CommonUtilities::eHashGrowth::Rehash);
+		TestSelfReferencingInsert<Map>(8, CommonUtilities::eHashGrowth::IncrementalRehash);
+		TestSelfReferencingKey<Map>(4096, CommonUtilities::eHashGrowth::Fixed);
+		TestSelfReferencingKey<Map>(8, CommonUtilities::eHashGrowth::Rehash);
+		TestSelfReferencingKey<Map>(8, CommonUtilities::eHashGrowth::IncrementalRehash);
+	}
+}
+
+int main()
+{
+	TestPolicies<CommonUtilities::LinearProbing, CommonUtilities::InterleavedStorage>();
+	TestPolicies<CommonUtilities::LinearProbing, CommonUtilities::SplitStorage>();
+	TestPolicies<CommonUtilities::RobinHoodProbing, CommonUtilities::InterleavedStorage>();
+	TestPolicies<CommonUtilities::RobinHoodProbing, CommonUtilities::SplitStorage>();
+
+	if (myFailureCount > 0)
+	{
+		printf("HashMap tests failed: %d checks\n", myFailureCount);
+		return 1;
+	}
+	printf("HashMap tests passed\n");
+	return 0;
+}
@@ -0,0 +1,233 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "../include/Heap.hpp"
+#include "../include/IndexedHeap.hpp"
+
+// Compares IndexedHeap with a Heap using lazy deletion. The lazy version enqueues a new entry whenever a
+// priority changes and skips stale entries as they come out, IndexedHeap moves the existing entry instead.
+// The workloads are Dijkstra over a grid with random edge weights, where few distances drop after they are
+// first set, and a fixed set of items reprioritized many times over. Each sums what it computes, so a wrong
+// result is reported instead of timed.
+namespace
+{
+	constexpr int myRepeats = 5;
+
+	struct Grid
+	{
+		int width = 0;
+		int height = 0;
+		std::vector<uint32_t> weights;	// Cost of entering each cell
+	};
+
+	struct OpenEntry
+	{
+		uint64_t distance;
+		int cell;
+	};
+
+	Grid MakeGrid(int aWidth, int aHeight, uint32_t aMaxWeight)
+	{
+		Grid grid;
+		grid.width = aWidth;
+		grid.height = aHeight;
+		grid.weights.resize(static_cast<size_t>(aWidth) * aHeight);
+		std::mt19937 random(1);
+		for (uint32_t& weight : grid.weights)
+		{
+			weight = 1 + random() % aMaxWeight;
+		}
+		return grid;
+	}
+
+	template <class Visit>
+	void ForEachNeighbour(const Grid& aGrid, int aCell, const Visit& aVisit)
+	{
+		const int x = aCell % aGrid.width;
+		const int y = aCell / aGrid.width;
+		if (x > 0) aVisit(aCell - 1);
+		if (x + 1 < aGrid.width) aVisit(aCell + 1);
+		if (y > 0) aVisit(aCell - aGrid.width);
+		if (y + 1 < aGrid.height) aVisit(aCell + aGrid.width);
+	}
+
+	uint64_t SumDistances(const std::vector<uint64_t>& aDistances)
+	{
+		uint64_t sum = 0;
+		for (uint64_t distance : aDistances)
+		{
+			sum += distance;
+		}
+		return sum;
+	}
+
+	uint64_t LazyHeapDijkstra(const Grid& aGrid)
+	{
+		std::vector<uint64_t> distances(aGrid.weights.size(), UINT64_MAX);
+		CommonUtilities::Heap<OpenEntry, std::greater<>, 4, decltype(&OpenEntry::distance)> open({}, &OpenEntry::distance);
+		distances[0] = 0;
+		open.Enqueue({ 0, 0 });
+		while (open.GetSize() > 0)
+		{
+			const OpenEntry entry = open.Dequeue();
+			if (entry.distance != distances[entry.cell])
+			{
+				continue;
+			}
+			ForEachNeighbour(aGrid, entry.cell, [&](int aNeighbour)
+			{
+				const uint64_t distance = entry.distance + aGrid.weights[aNeighbour];
+				if (distance < distances[aNeighbour])
+				{
+					distances[aNeighbour] = distance;
+					open.Enqueue({ distance, aNeighbour });
+				}
+			});
+		}
+		return SumDistances(distances);
+	}
+
+	uint64_t IndexedHeapDijkstra(const Grid& aGrid)
+	{
+		using OpenList = CommonUtilities::IndexedHeap<OpenEntry, std::greater<>, 4, decltype(&OpenEntry::distance)>;
+		constexpr OpenList::Handle noHandle = UINT32_MAX;
+
+		std::vector<uint64_t> distances(aGrid.weights.size(), UINT64_MAX);
+		std::vector<OpenList::Handle> handles(aGrid.weights.size(), noHandle);
+		OpenList open({}, &OpenEntry::distance);
+		distances[0] = 0;
+		handles[0] = open.Enqueue({ 0, 0 });
+		while (open.GetSize() > 0)
+		{
+			const OpenEntry entry = open.Dequeue();
+			handles[entry.cell] = noHandle;
+			ForEachNeighbour(aGrid, entry.cell, [&](int aNeighbour)
+			{
+				const uint64_t distance = entry.distance + aGrid.weights[aNeighbour];
+				if (distance < distances[aNeighbour])
+				{
+					distances[aNeighbour] = distance;
+					if (handles[aNeighbour] == noHandle)
+					{
+						handles[aNeighbour] = open.Enqueue({ distance, aNeighbour });
+					}
+					else
+					{
+						// std::greater orders a shorter distance higher, so it is an IncreaseKey
+						open.IncreaseKey(handles[aNeighbour], { distance, aNeighbour });
+					}
+				}
+			});
+		}
+		return SumDistances(distances);
+	}
+
+	// Changes the priority of a random item aUpdateCount times, then drains the heap. Returns the sum of
+	// the drained priorities, weighted by drain order.
+	uint64_t LazyHeapReprioritize(int aItemCount, int aUpdateCount)
+	{
+		std::vector<uint64_t> priorities(aItemCount);
+		CommonUtilities::Heap<OpenEntry, std::less<>, 4, decltype(&OpenEntry::distance)> open({}, &OpenEntry::distance);
+		std::mt19937 random(2);
+		for (int i = 0; i < aItemCount; i++)
+		{
+			priorities[i] = random() % 1000000;
+			open.Enqueue({ priorities[i], i });
+		}
+		for (int i = 0; i < aUpdateCount; i++)
+		{
+			const int item = static_cast<int>(random() % aItemCount);
+			priorities[item] = random() % 1000000;
+			open.Enqueue({ priorities[item], item });
+		}
+
+		uint64_t sum = 0;
+		uint64_t order = 1;
+		while (open.GetSize() > 0)
+		{
+			const OpenEntry entry = open.Dequeue();
+			if (entry.distance != priorities[entry.cell])
+			{
+				continue;
+			}
+			// Equal priorities may be queued twice for the same item, only the first one counts
+			priorities[entry.cell] = UINT64_MAX;
+			sum += entry.distance * order++;
+		}
+		return sum;
+	}
+
+	uint64_t IndexedHeapReprioritize(int aItemCount, int aUpdateCount)
+	{
+		using OpenList = CommonUtilities::IndexedHeap<OpenEntry, std::less<>, 4, decltype(&OpenEntry::distance)>;
+		std::vector<OpenList::Handle> handles(aItemCount);
+		OpenList open({}, &OpenEntry::distance);
+		std::mt19937 random(2);
+		for (int i = 0; i < aItemCount; i++)
+		{
+			handles[i] = open.Enqueue({ random() % 1000000, i });
+		}
+		for (int i = 0; i < aUpdateCount; i++)
+		{
+			const int item = static_cast<int>(random() % aItemCount);
+			open.Update(handles[item], { random() % 1000000, item });
+		}
+
+		uint64_t sum = 0;
+		uint64_t order = 1;
+		while (open.GetSize() > 0)
+		{
+			sum += open.Dequeue().distance * order++;
+		}
+		return sum;
+	}
+
+	template <class Workload>
+	void Measure(const char* aName, uint64_t aExpected, Workload&& aWorkload)
+	{
+		double best = 0.0;
+		for (int repeat = 0; repeat < myRepeats; repeat++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			const uint64_t sum = aWorkload();
+			const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (sum != aExpected)
+			{
+				printf("  %-16s returned the wrong result\n", aName);
+				return;
+			}
+			best = (repeat == 0 || milliseconds < best) ? milliseconds : best;
+		}
+		printf("  %-16s %10.3f ms\n", aName, best);
+	}
+
+	void RunDijkstra(int aSize, uint32_t aMaxWeight)
+	{
+		printf("Dijkstra over a %dx%d grid, weights 1 to %u\n", aSize, aSize, aMaxWeight);
+		const Grid grid = MakeGrid(aSize, aSize, aMaxWeight);
+		const uint64_t expected = LazyHeapDijkstra(grid);
+		Measure("IndexedHeap", expected, [&] { return IndexedHeapDijkstra(grid); });
+		Measure("Lazy Heap", expected, [&] { return LazyHeapDijkstra(grid); });
+	}
+
+	void RunReprioritize(int aItemCount, int aUpdateCount)
+	{
+		printf("Reprioritize %d items %d times, then drain\n", aItemCount, aUpdateCount);
+		const uint64_t expected = LazyHeapReprioritize(aItemCount, aUpdateCount);
+		Measure("IndexedHeap", expected, [=] { return IndexedHeapReprioritize(aItemCount, aUpdateCount); });
+		Measure("Lazy Heap", expected, [=] { return LazyHeapReprioritize(aItemCount, aUpdateCount); });
+	}
+}
+
+int main()
+{
+	RunDijkstra(256, 10);
+	RunDijkstra(256, 1000);
+	RunDijkstra(1024, 10);
+	RunDijkstra(1024, 1000);
+	RunReprioritize(1000, 1000000);
+	RunReprioritize(100000, 1000000);
+	return 0;
+}
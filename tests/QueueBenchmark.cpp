@@ -0,0 +1,198 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include "../include/Queue.hpp"
+
+// Compares the ring buffer Queue with std::deque and with the vector backed Queue it replaced, which is
+// kept here verbatim as BaselineQueue. Each workload sums what it dequeues, so an implementation that
+// returns the wrong elements is reported instead of timed.
+namespace
+{
+	template <class T>
+	class BaselineQueue
+	{
+	public:
+		BaselineQueue()
+		{
+			myFirst = 0;
+			myLast = 0;
+			mySize = 0;
+		}
+
+		int GetSize() const
+		{
+			return mySize;
+		}
+
+		void Enqueue(const T& aValue)
+		{
+			if (myFirst == 0)
+			{
+				myQueue.emplace_back(aValue);
+				myLast++;
+			}
+			else if (myFirst == myLast && mySize > 0)
+			{
+				auto it = myQueue.begin() + myLast;
+				myQueue.insert(it, aValue);
+				myLast++;
+				myFirst++;
+			}
+			else if (myFirst > 0)
+			{
+				if (myFirst < myLast) myLast = 1;
+				else myLast++;
+				myQueue[myLast - 1] = aValue;
+			}
+			mySize++;
+		}
+
+		T Dequeue()
+		{
+			assert(mySize > 0 && "Queue size is empty");
+			myFirst++;
+			mySize--;
+			if (!myQueue.size()) return 0;
+			else if (mySize == 0)
+			{
+				auto returnValue = myQueue[myFirst - 1];
+				myFirst = 0;
+				myLast = 0;
+				mySize = 0;
+				myQueue.clear();
+				return returnValue;
+			}
+			else if (myFirst >= static_cast<int>(myQueue.size()))
+			{
+				myFirst = 0;
+				return myQueue[myQueue.size() - 1];
+			}
+			return myQueue[myFirst - 1];
+		}
+
+	private:
+		std::vector<T> myQueue;
+		int myFirst;
+		int myLast;
+		int mySize;
+	};
+
+	// Same interface over std::deque
+	template <class T>
+	class DequeQueue
+	{
+	public:
+		int GetSize() const
+		{
+			return static_cast<int>(myQueue.size());
+		}
+
+		void Enqueue(const T& aValue)
+		{
+			myQueue.push_back(aValue);
+		}
+
+		T Dequeue()
+		{
+			T value = myQueue.front();
+			myQueue.pop_front();
+			return value;
+		}
+
+	private:
+		std::deque<T> myQueue;
+	};
+
+	constexpr int myRepeats = 5;
+
+	// Fills the queue with aCount elements and drains it, aRounds times
+	template <class QueueType>
+	uint64_t FillAndDrain(int aCount, int aRounds)
+	{
+		QueueType queue;
+		uint64_t sum = 0;
+		for (int round = 0; round < aRounds; round++)
+		{
+			for (int i = 0; i < aCount; i++)
+			{
+				queue.Enqueue(static_cast<uint64_t>(i));
+			}
+			while (queue.GetSize() > 0)
+			{
+				sum += queue.Dequeue();
+			}
+		}
+		return sum;
+	}
+
+	// Keeps aWindow elements queued while aCount elements pass through, like a producer/consumer buffer
+	template <class QueueType>
+	uint64_t SlidingWindow(int aWindow, int aCount)
+	{
+		QueueType queue;
+		uint64_t sum = 0;
+		for (int i = 0; i < aWindow; i++)
+		{
+			queue.Enqueue(static_cast<uint64_t>(i));
+		}
+		for (int i = aWindow; i < aCount; i++)
+		{
+			queue.Enqueue(static_cast<uint64_t>(i));
+			sum += queue.Dequeue();
+		}
+		while (queue.GetSize() > 0)
+		{
+			sum += queue.Dequeue();
+		}
+		return sum;
+	}
+
+	template <class Workload>
+	void Measure(const char* aName, uint64_t aExpected, Workload&& aWorkload)
+	{
+		double best = 0.0;
+		for (int repeat = 0; repeat < myRepeats; repeat++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			const uint64_t sum = aWorkload();
+			const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (sum != aExpected)
+			{
+				printf("  %-16s returned the wrong elements\n", aName);
+				return;
+			}
+			best = (repeat == 0 || milliseconds < best) ? milliseconds : best;
+		}
+		printf("  %-16s %10.3f ms\n", aName, best);
+	}
+
+	void RunFillAndDrain(int aCount, int aRounds)
+	{
+		printf("Fill %d and drain, %d rounds\n", aCount, aRounds);
+		const uint64_t expected = static_cast<uint64_t>(aCount) * (aCount - 1) / 2 * aRounds;
+		Measure("Queue", expected, [=] { return FillAndDrain<CommonUtilities::Queue<uint64_t>>(aCount, aRounds); });
+		Measure("BaselineQueue", expected, [=] { return FillAndDrain<BaselineQueue<uint64_t>>(aCount, aRounds); });
+		Measure("std::deque", expected, [=] { return FillAndDrain<DequeQueue<uint64_t>>(aCount, aRounds); });
+	}
+
+	void RunSlidingWindow(int aWindow, int aCount)
+	{
+		printf("Sliding window of %d over %d elements\n", aWindow, aCount);
+		const uint64_t expected = static_cast<uint64_t>(aCount) * (aCount - 1) / 2;
+		Measure("Queue", expected, [=] { return SlidingWindow<CommonUtilities::Queue<uint64_t>>(aWindow, aCount); });
+		Measure("BaselineQueue", expected, [=] { return SlidingWindow<BaselineQueue<uint64_t>>(aWindow, aCount); });
+		Measure("std::deque", expected, [=] { return SlidingWindow<DequeQueue<uint64_t>>(aWindow, aCount); });
+	}
+}
+
+int main()
+{
+	RunFillAndDrain(1000, 1000);
+	RunFillAndDrain(1000000, 4);
+	RunSlidingWindow(16, 1000000);
+	RunSlidingWindow(1000, 200000);
+	return 0;
+}
@@ -0,0 +1,155 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include "../include/Queue.hpp"
+
+// Functional tests for the ring buffer Queue, checked against std::deque
+namespace
+{
+	int myFailureCount = 0;
+
+	void Check(bool aCondition, const char* aMessage)
+	{
+		if (!aCondition)
+		{
+			printf("FAILED: %s\n", aMessage);
+			myFailureCount++;
+		}
+	}
+
+	// Heap allocated strings, so reading a freed buffer is caught by sanitizers and debug heaps
+	std::string MakeValue(int aIndex)
+	{
+		return "value number " + std::to_string(aIndex) + " long enough to allocate";
+	}
+
+	void TestAgainstDeque()
+	{
+		CommonUtilities::Queue<std::string> queue;
+		std::deque<std::string> reference;
+		srand(1);
+		for (int i = 0; i < 100000; i++)
+		{
+			if (rand() % 3 != 0 || reference.empty())
+			{
+				queue.Enqueue(MakeValue(i));
+				reference.push_back(MakeValue(i));
+			}
+			else
+			{
+				Check(queue.GetFront() == reference.front(), "GetFront matches std::deque");
+				Check(queue.Dequeue() == reference.front(), "Dequeue matches std::deque");
+				reference.pop_front();
+			}
+			Check(queue.GetSize() == static_cast<int>(reference.size()), "GetSize matches std::deque");
+		}
+	}
+
+	void TestSelfReferencingEnqueue()
+	{
+		// Each round fills the queue to capacity so the next Enqueue grows it while reading its own front
+		CommonUtilities::Queue<std::string> queue;
+		queue.Enqueue(MakeValue(0));
+		for (int round = 0; round < 8; round++)
+		{
+			while (queue.GetSize() < queue.GetCapacity())
+			{
+				queue.Enqueue(MakeValue(queue.GetSize()));
+			}
+			queue.Enqueue(queue.GetFront());
+			Check(queue.GetSize() == queue.GetCapacity() / 2 + 1, "Enqueue(const T&) of an element grows the queue");
+		}
+
+		CommonUtilities::Queue<std::string> moved;
+		for (int i = 0; i < 8; i++)
+		{
+			moved.Enqueue(MakeValue(i));
+		}
+		moved.Emplace(moved.GetFront(), 0, 5);
+		Check(moved.GetSize() == 9, "Emplace from an element grows the queue");
+
+		while (moved.GetSize() > 1)
+		{
+			moved.Dequeue();
+		}
+		Check(moved.GetFront() == "value", "Emplace from an element constructs from its old value");
+
+		CommonUtilities::Queue<std::string> wrapped;
+		for (int i = 0; i < 8; i++)
+		{
+			wrapped.Enqueue(MakeValue(i));
+		}
+		for (int i = 0; i < 5; i++)
+		{
+			wrapped.Dequeue();
+			wrapped.Enqueue(MakeValue(i + 8));
+		}
+		wrapped.Enqueue(std::move(wrapped.GetFront()));
+		while (wrapped.GetSize() > 1)
+		{
+			wrapped.Dequeue();
+		}
+		Check(wrapped.GetFront() == MakeValue(5), "Enqueue(T&&) of a wrapped element moves the right value");
+	}
+
+	void TestCapacityRetention()
+	{
+		CommonUtilities::Queue<int> queue;
+		for (int i = 0; i < 1000; i++)
+		{
+			queue.Enqueue(i);
+		}
+		const int capacity = queue.GetCapacity();
+		while (queue.GetSize() > 0)
+		{
+			queue.Dequeue();
+		}
+		Check(queue.GetCapacity() == capacity, "Draining keeps the capacity");
+		queue.Clear();
+		Check(queue.GetCapacity() == capacity, "Clear keeps the capacity");
+		queue.Reserve(5000);
+		Check(queue.GetCapacity() >= 5000, "Reserve grows the capacity");
+	}
+
+	void TestCopyAndMove()
+	{
+		CommonUtilities::Queue<std::string> queue;
+		for (int i = 0; i < 20; i++)
+		{
+			queue.Enqueue(MakeValue(i));
+		}
+		queue.Dequeue();
+
+		CommonUtilities::Queue<std::string> copy(queue);
+		Check(copy.GetSize() == queue.GetSize() && copy.GetFront() == queue.GetFront(), "Copy keeps the elements in order");
+		CommonUtilities::Queue<std::string> moved(std::move(copy));
+		Check(moved.GetSize() == 19 && copy.GetSize() == 0, "Move takes the elements");
+		copy = moved;
+		Check(copy.GetSize() == 19 && copy.GetFront() == MakeValue(1), "Copy assignment keeps the elements in order");
+
+		CommonUtilities::Queue<std::unique_ptr<int>> pointers;
+		for (int i = 0; i < 20; i++)
+		{
+			pointers.Emplace(new int(i));
+		}
+		Check(*pointers.Dequeue() == 0 && *pointers.GetFront() == 1, "Move-only elements");
+	}
+}
+
+int main()
+{
+	TestAgainstDeque();
+	TestSelfReferencingEnqueue();
+	TestCapacityRetention();
+	TestCopyAndMove();
+
+	if (myFailureCount > 0)
+	{
+		printf("Queue tests failed: %d checks\n", myFailureCount);
+		return 1;
+	}
+	printf("Queue tests passed\n");
+	return 0;
+}
@@ -0,0 +1,185 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../include/WorkStealingDeque.hpp"
+
+// Compares WorkStealingDeque with a std::deque behind a mutex, offering the same Push, Pop and Steal.
+// Every workload sums the elements it takes, so an implementation that loses or duplicates elements is
+// reported instead of timed.
+namespace
+{
+	constexpr int myRepeats = 5;
+
+	class LockedDeque
+	{
+	public:
+		void Push(const uint32_t& aValue)
+		{
+			std::lock_guard lock(myMutex);
+			myDeque.push_back(aValue);
+		}
+
+		bool Pop(uint32_t& outValue)
+		{
+			std::lock_guard lock(myMutex);
+			if (myDeque.empty())
+			{
+				return false;
+			}
+			outValue = myDeque.back();
+			myDeque.pop_back();
+			return true;
+		}
+
+		bool Steal(uint32_t& outValue)
+		{
+			std::lock_guard lock(myMutex);
+			if (myDeque.empty())
+			{
+				return false;
+			}
+			outValue = myDeque.front();
+			myDeque.pop_front();
+			return true;
+		}
+
+		bool IsEmpty() const
+		{
+			std::lock_guard lock(myMutex);
+			return myDeque.empty();
+		}
+
+	private:
+		mutable std::mutex myMutex;
+		std::deque<uint32_t> myDeque;
+	};
+
+	// The owner pushes aCount elements in batches of aBatch and pops each batch back, with no thieves
+	template <class Deque>
+	uint64_t OwnerOnly(uint32_t aCount, uint32_t aBatch)
+	{
+		Deque deque;
+		uint64_t sum = 0;
+		uint32_t value;
+		for (uint32_t first = 0; first < aCount; first += aBatch)
+		{
+			for (uint32_t i = first; i < first + aBatch && i < aCount; i++)
+			{
+				deque.Push(i);
+			}
+			while (deque.Pop(value))
+			{
+				sum += value;
+			}
+		}
+		return sum;
+	}
+
+	// The owner pushes aCount elements and pops one after every aPopEvery pushes, while aThiefCount
+	// threads steal until the owner is done and the deque is empty
+	template <class Deque>
+	uint64_t WithThieves(uint32_t aCount, uint32_t aPopEvery, int aThiefCount)
+	{
+		Deque deque;
+		std::atomic<bool> isDone = false;
+		std::vector<uint64_t> stolenSums(aThiefCount, 0);
+		std::vector<std::thread> thieves;
+		for (int i = 0; i < aThiefCount; i++)
+		{
+			thieves.emplace_back([&, i]
+			{
+				uint64_t sum = 0;
+				uint32_t value;
+				while (!isDone.load(std::memory_order_acquire) || !deque.IsEmpty())
+				{
+					if (deque.Steal(value))
+					{
+						sum += value;
+					}
+				}
+				stolenSums[i] = sum;
+			});
+		}
+
+		uint64_t sum = 0;
+		uint32_t value;
+		for (uint32_t i = 0; i < aCount; i++)
+		{
+			deque.Push(i);
+			if (i % aPopEvery == 0 && deque.Pop(value))
+			{
+				sum += value;
+			}
+		}
+		while (deque.Pop(value))
+		{
+			sum += value;
+		}
+
+		isDone.store(true, std::memory_order_release);
+		for (int i = 0; i < aThiefCount; i++)
+		{
+			thieves[i].join();
+			sum += stolenSums[i];
+		}
+		return sum;
+	}
+
+	template <class Workload>
+	void Measure(const char* aName, uint64_t aExpected, Workload&& aWorkload)
+	{
+		double best = 0.0;
+		for (int repeat = 0; repeat < myRepeats; repeat++)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			const uint64_t sum = aWorkload();
+			const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (sum != aExpected)
+			{
+				printf("  %-20s lost or duplicated elements\n", aName);
+				return;
+			}
+			best = (repeat == 0 || milliseconds < best) ? milliseconds : best;
+		}
+		printf("  %-20s %10.3f ms\n", aName, best);
+	}
+
+	uint64_t GetExpectedSum(uint32_t aCount)
+	{
+		return static_cast<uint64_t>(aCount) * (aCount - 1) / 2;
+	}
+
+	void RunOwnerOnly(uint32_t aCount, uint32_t aBatch)
+	{
+		printf("Owner only, %u elements in batches of %u\n", aCount, aBatch);
+		Measure("WorkStealingDeque", GetExpectedSum(aCount), [=] { return OwnerOnly<CommonUtilities::WorkStealingDeque<uint32_t>>(aCount, aBatch); });
+		Measure("Locked std::deque", GetExpectedSum(aCount), [=] { return OwnerOnly<LockedDeque>(aCount, aBatch); });
+	}
+
+	void RunWithThieves(uint32_t aCount, uint32_t aPopEvery, int aThiefCount)
+	{
+		printf("%u elements, owner pops every %u pushes, %d thieves\n", aCount, aPopEvery, aThiefCount);
+		Measure("WorkStealingDeque", GetExpectedSum(aCount), [=] { return WithThieves<CommonUtilities::WorkStealingDeque<uint32_t>>(aCount, aPopEvery, aThiefCount); });
+		Measure("Locked std::deque", GetExpectedSum(aCount), [=] { return WithThieves<LockedDeque>(aCount, aPopEvery, aThiefCount); });
+	}
+}
+
+int main()
+{
+	RunOwnerOnly(4000000, 1);
+	RunOwnerOnly(4000000, 256);
+
+	const int coreCount = static_cast<int>(std::thread::hardware_concurrency());
+	const int maxThiefCount = (coreCount > 2) ? coreCount - 1 : 1;
+	for (int thiefCount = 1; thiefCount <= maxThiefCount; thiefCount *= 2)
+	{
+		RunWithThieves(1000000, 1, thiefCount);
+		RunWithThieves(1000000, 4, thiefCount);
+	}
+	return 0;
+}
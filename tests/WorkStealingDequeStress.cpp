@@ -0,0 +1,96 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../include/WorkStealingDeque.hpp"
+
+// Stress test for WorkStealingDeque: one owner pushes and pops while several thieves steal, and every
+// element has to come out exactly once. The deque starts small so growth runs while thieves are active.
+namespace
+{
+	constexpr int myRounds = 20;
+	constexpr int myThiefCount = 4;
+	constexpr uint32_t myElementCount = 200000;
+
+	bool RunRound(int aRound)
+	{
+		CommonUtilities::WorkStealingDeque<uint32_t> deque(2);
+		std::unique_ptr<std::atomic<uint8_t>[]> taken(new std::atomic<uint8_t>[myElementCount]);
+		for (uint32_t i = 0; i < myElementCount; i++)
+		{
+			taken[i].store(0, std::memory_order_relaxed);
+		}
+
+		std::atomic<bool> isDone = false;
+		std::atomic<uint32_t> stolenCount = 0;
+		std::vector<std::thread> thieves;
+		for (int i = 0; i < myThiefCount; i++)
+		{
+			thieves.emplace_back([&]
+			{
+				uint32_t value;
+				while (!isDone.load(std::memory_order_acquire) || !deque.IsEmpty())
+				{
+					if (deque.Steal(value))
+					{
+						taken[value].fetch_add(1, std::memory_order_relaxed);
+						stolenCount.fetch_add(1, std::memory_order_relaxed);
+					}
+				}
+			});
+		}
+
+		// Vary how often the owner pops so both the plain and the last-element paths race with thieves
+		uint32_t poppedCount = 0;
+		uint32_t value;
+		const uint32_t popEvery = static_cast<uint32_t>(aRound % 4) + 1;
+		for (uint32_t i = 0; i < myElementCount; i++)
+		{
+			deque.Push(i);
+			if (i % popEvery == 0 && deque.Pop(value))
+			{
+				taken[value].fetch_add(1, std::memory_order_relaxed);
+				poppedCount++;
+			}
+		}
+		while (deque.Pop(value))
+		{
+			taken[value].fetch_add(1, std::memory_order_relaxed);
+			poppedCount++;
+		}
+
+		isDone.store(true, std::memory_order_release);
+		for (std::thread& thief : thieves)
+		{
+			thief.join();
+		}
+
+		for (uint32_t i = 0; i < myElementCount; i++)
+		{
+			const uint8_t count = taken[i].load(std::memory_order_relaxed);
+			if (count != 1)
+			{
+				printf("Round %d: element %u came out %u times\n", aRound, i, count);
+				return false;
+			}
+		}
+		printf("Round %d: %u popped, %u stolen\n", aRound, poppedCount, stolenCount.load());
+		return poppedCount + stolenCount.load() == myElementCount;
+	}
+}
+
+int main()
+{
+	for (int round = 0; round < myRounds; round++)
+	{
+		if (!RunRound(round))
+		{
+			printf("WorkStealingDeque stress test failed\n");
+			return 1;
+		}
+	}
+	printf("WorkStealingDeque stress test passed\n");
+	return 0;
+}